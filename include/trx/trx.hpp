@@ -4,15 +4,98 @@
 #define TRX_NAMESPACE trx
 #endif  // TRX_NAMESPACE
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <bitset>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
 #include <functional>
 #include <istream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
 #include <tuple>
 #include <type_traits>
+#include <utility>
+#include <vector>
+
+// File descriptor and memory mapping support (`write_lines` to a descriptor, `read_blocks`, `read_columns`) needs the
+// POSIX headers, which declare many names and macros in the global namespace; it is enabled by defining
+// TRX_ENABLE_POSIX before including this header.
+#if defined(TRX_ENABLE_POSIX) && __has_include(<unistd.h>)
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define TRX_HAS_POSIX 1
+#endif  // defined(TRX_ENABLE_POSIX) && __has_include(<unistd.h>)
 
 namespace TRX_NAMESPACE
 {
 
+namespace detail
+{
+
+struct no_run_state_t
+{
+};
+
+template <class Reducer, class = void>
+struct run_state_impl
+{
+    using type = no_run_state_t;
+    static constexpr bool value = false;
+};
+
+template <class Reducer>
+struct run_state_impl<Reducer, std::void_t<typename Reducer::run_state_type>>
+{
+    using type = typename Reducer::run_state_type;
+    static constexpr bool value = true;
+};
+
+// Reducers whose own part of the run state may be split between chunks of a parallel run declare
+// `static constexpr bool run_state_per_chunk = true`.
+template <class Reducer, class = void>
+struct run_state_per_chunk_impl : std::false_type
+{
+};
+
+template <class Reducer>
+struct run_state_per_chunk_impl<Reducer, std::void_t<decltype(Reducer::run_state_per_chunk)>>
+    : std::bool_constant<Reducer::run_state_per_chunk>
+{
+};
+
+}  // namespace detail
+
+// Per-run state of a reducer (counters, flags, ...). Reducers which need one expose `run_state_type` and are
+// invoked with `(State&, run_state_type&, Args&&...)`, so that the reducer itself stays immutable and a single
+// reductor can be executed repeatedly or concurrently.
+template <class Reducer>
+using run_state_t = typename detail::run_state_impl<Reducer>::type;
+
+template <class Reducer>
+inline constexpr bool has_run_state_v = detail::run_state_impl<Reducer>::value;
+
 template <class State, class Reducer>
 struct reductor_t
 {
@@ -21,17 +104,18 @@ struct reductor_t
 
     state_type state;
     reducer_type reducer;
+    // Run state of the items pushed directly with operator(); the executors (`|=`) start a run of their own.
+    run_state_t<reducer_type> run_state = {};
 
     constexpr operator state_type() const
     {
         return state;
     }
 
+    // Pushes a single item into the state. Consecutive calls form a single run, so e.g. `take(1)` keeps the first item
+    // only; like `out`, it never signals the end of the input.
     template <class... Args>
-    constexpr auto operator()(Args&&... args) -> bool
-    {
-        return std::invoke(reducer, state, std::forward<Args>(args)...);
-    }
+    constexpr auto operator()(Args&&... args) -> bool;
 
     constexpr auto get() const& -> const state_type&
     {
@@ -52,6 +136,29 @@ struct reductor_t
 template <class State, class Reducer>
 reductor_t(State&&, Reducer&&) -> reductor_t<std::decay_t<State>, std::decay_t<Reducer>>;
 
+// Reductor executed over contiguous chunks of a range, one run per worker. The per-worker states are passed to
+// `Merge` as `std::vector<State>` which produces the result.
+//
+// With `m_chunks_per_worker` set, the range is split into `workers * m_chunks_per_worker` chunks instead, which idle
+// workers take one by one to balance uneven per-item costs. Each worker then runs over the chunks it took into its own
+// state, or, if `m_stable`, each chunk is reduced into its own state so that the states stay in the input order.
+//
+// Transducers with per-run state (`take`, `drop`, `distinct`, ...) placed in front of it have to see the whole input in
+// a single run; `m_sequential` is then set and the range is reduced in a single run on the calling thread instead.
+template <class State, class Reducer, class Merge>
+struct parallel_reductor_t
+{
+    using state_type = State;
+    using reducer_type = Reducer;
+
+    reductor_t<State, Reducer> m_reductor;
+    Merge m_merge;
+    std::size_t m_workers;
+    std::size_t m_chunks_per_worker = 0;
+    bool m_stable = false;
+    bool m_sequential = false;
+};
+
 template <class State, class Reducer>
 constexpr auto make_reductor(State&& state, Reducer&& reducer) -> reductor_t<std::decay_t<State>, std::decay_t<Reducer>>
 {
@@ -96,1208 +203,5967 @@ using generator_t = std::function<void(yield_fn<Args...>)>;
 namespace detail
 {
 
-template <class Callable>
-using return_type_t = typename decltype(std::function{ std::declval<Callable>() })::result_type;
-
-template <class T, class = void>
-struct is_generator_impl : std::false_type
-{
-};
-
-template <class YieldFn>
-struct is_generator_impl<std::function<void(YieldFn)>, std::enable_if_t<std::is_convertible_v<return_type_t<YieldFn>, bool>>>
-    : std::true_type
-{
-};
-
 template <class T>
-struct is_reductor_impl : std::false_type
-{
-};
-
-template <class S, class R>
-struct is_reductor_impl<reductor_t<S, R>> : std::true_type
-{
-};
-
-template <class T, class = void>
-struct is_range_impl : std::false_type
-{
-};
+struct member_pointer_class;
 
-template <class T>
-struct is_range_impl<T, std::void_t<decltype(std::begin(std::declval<T&>())), decltype(std::end(std::declval<T&>()))>>
-    : std::true_type
+template <class Member, class Class>
+struct member_pointer_class<Member Class::*>
 {
+    using type = Class;
 };
 
-template <class T>
-struct is_transducer_impl
+template <class Member, class Object, class... Args>
+constexpr auto invoke_member(Member member, Object&& object, Args&&... args) -> decltype(auto)
 {
-    static constexpr bool value = !is_generator_impl<T>::value && !is_reductor_impl<T>::value && !is_range_impl<T>::value;
-};
-
-}  // namespace detail
-
-template <class T>
-inline constexpr bool is_generator_v = detail::is_generator_impl<T>::value;
-
-template <class T>
-inline constexpr bool is_transducer_v = detail::is_transducer_impl<T>::value;
-
-template <class T>
-inline constexpr bool is_range_v = detail::is_range_impl<T>::value;
+    using class_type = typename member_pointer_class<std::decay_t<Member>>::type;
+    if constexpr (!std::is_base_of_v<class_type, std::decay_t<Object>>)
+    {
+        return std::invoke(member, std::forward<Object>(object), std::forward<Args>(args)...);
+    }
+    else if constexpr (std::is_member_function_pointer_v<std::decay_t<Member>>)
+    {
+        return (std::forward<Object>(object).*member)(std::forward<Args>(args)...);
+    }
+    else
+    {
+        return std::forward<Object>(object).*member;
+    }
+}
 
-template <
-    class Generator,
-    class State,
-    class Reducer,
-    class G = std::decay_t<Generator>,
-    std::enable_if_t<is_generator_v<G>, int> = 0>
-constexpr auto operator|=(Generator&& generator, reductor_t<State, Reducer> reductor) -> State
+// std::invoke, usable in constant expressions (std::invoke is constexpr only since C++20).
+template <class Func, class... Args>
+constexpr auto invoke(Func&& func, Args&&... args) -> decltype(auto)
 {
-    std::forward<Generator>(generator)(reductor);
-    return reductor.state;
+    if constexpr (std::is_member_pointer_v<std::decay_t<Func>>)
+    {
+        return invoke_member(func, std::forward<Args>(args)...);
+    }
+    else
+    {
+        return std::forward<Func>(func)(std::forward<Args>(args)...);
+    }
 }
 
-template <
-    class Transducer,
-    class State,
-    class Reducer,
-    class T = std::decay_t<Transducer>,
-    std::enable_if_t<is_transducer_v<T>, int> = 0>
-constexpr auto operator|=(Transducer&& transducer, const reductor_t<State, Reducer>& reductor)
-    -> reductor_t<State, std::invoke_result_t<Transducer, Reducer>>
+// 64-bit finalizer of MurmurHash3, the same on all platforms.
+constexpr auto fmix64(std::uint64_t h) -> std::uint64_t
 {
-    return { reductor.state, std::invoke(std::forward<Transducer>(transducer), reductor.reducer) };
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
 }
 
-template <
-    class Transducer,
-    class State,
-    class Reducer,
-    class T = std::decay_t<Transducer>,
-    std::enable_if_t<is_transducer_v<T>, int> = 0>
-constexpr auto operator|=(Transducer&& transducer, reductor_t<State, Reducer>&& reductor)
-    -> reductor_t<State, std::invoke_result_t<Transducer, Reducer>>
+// Spreads the entropy of weak hashes (such as identity hashes of integers) over all bits.
+constexpr auto mix_hash(std::uint64_t h) -> std::size_t
 {
-    return { std::move(reductor.state), std::invoke(std::forward<Transducer>(transducer), std::move(reductor.reducer)) };
+    return static_cast<std::size_t>(fmix64(h));
 }
 
-template <class Range, class State, class Reducer, class R = std::decay_t<Range>, std::enable_if_t<is_range_v<R>, int> = 0>
-constexpr auto operator|=(Range&& range, reductor_t<State, Reducer> reductor) -> State
+}  // namespace detail
+
+// Open-addressing hash map with linear probing. Entries are stored densely in insertion order, the probe table holds
+// precomputed hashes and entry indices only.
+template <class Key, class Value, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>>
+class flat_hash_map
 {
-    auto it = std::begin(range);
-    const auto end = std::end(range);
-    for (; it != end; ++it)
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<Key, Value>;
+    using size_type = std::size_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using iterator = typename std::vector<value_type>::iterator;
+    using const_iterator = typename std::vector<value_type>::const_iterator;
+
+    flat_hash_map() = default;
+
+    explicit flat_hash_map(hasher hash, key_equal equal = {}) : m_hash{ std::move(hash) }, m_equal{ std::move(equal) }
     {
-        if (!reductor(*it))
-        {
-            break;
-        }
     }
-    return reductor.state;
-}
 
-namespace detail
-{
+    auto begin() -> iterator
+    {
+        return m_values.begin();
+    }
 
-struct to_reducer_fn
-{
-    template <class Reducer>
-    struct adapter_t
+    auto end() -> iterator
     {
-        Reducer m_reducer;
+        return m_values.end();
+    }
 
-        template <class State, class... Args>
-        constexpr auto operator()(State& state, Args&&... args) const -> bool
-        {
-            state = std::invoke(m_reducer, std::move(state), std::forward<Args>(args)...);
-            return true;
-        }
-    };
+    auto begin() const -> const_iterator
+    {
+        return m_values.begin();
+    }
 
-    template <class Reducer>
-    constexpr auto operator()(Reducer&& reducer) const -> adapter_t<std::decay_t<Reducer>>
+    auto end() const -> const_iterator
     {
-        return { std::forward<Reducer>(reducer) };
+        return m_values.end();
     }
-};
 
-template <class State, class Reducer>
-struct output_iterator_t
-{
-    using iterator_category = std::output_iterator_tag;
-    using value_type = void;
-    using difference_type = void;
-    using pointer = void;
-    using reference = void;
-    using state_type = State;
-    using reducer_type = Reducer;
+    auto size() const -> size_type
+    {
+        return m_values.size();
+    }
 
-    reductor_t<State, Reducer> m_reductor;
+    auto empty() const -> bool
+    {
+        return m_values.empty();
+    }
 
-    constexpr auto operator*() -> output_iterator_t&
+    void clear()
     {
-        return *this;
+        m_values.clear();
+        m_slots.clear();
     }
 
-    constexpr auto operator++() -> output_iterator_t&
+    void reserve(size_type count)
     {
-        return *this;
+        m_values.reserve(count);
+        if (count * 4 > m_slots.size() * 3)
+        {
+            rehash(capacity_for(count));
+        }
     }
 
-    constexpr auto operator++(int) -> output_iterator_t&
+    auto hash(const key_type& key) const -> std::size_t
     {
-        return *this;
+        return detail::mix_hash(detail::invoke(m_hash, key));
     }
 
-    template <class Arg>
-    constexpr auto operator=(Arg&& arg) -> output_iterator_t&
+    auto find(const key_type& key) -> iterator
     {
-        m_reductor(std::forward<Arg>(arg));
-        return *this;
+        return find(key, hash(key));
     }
 
-    constexpr auto get() const& -> const state_type&
+    auto find(const key_type& key) const -> const_iterator
     {
-        return m_reductor.state;
+        return find(key, hash(key));
     }
 
-    constexpr auto get() & -> state_type&
+    auto find(const key_type& key, std::size_t hash) -> iterator
     {
-        return m_reductor.state;
+        const auto index = find_index(key, hash);
+        return index != npos ? begin() + index : end();
     }
 
-    constexpr auto get() && -> state_type&&
+    auto find(const key_type& key, std::size_t hash) const -> const_iterator
     {
-        return std::move(m_reductor.state);
+        const auto index = find_index(key, hash);
+        return index != npos ? begin() + index : end();
     }
-};
 
-struct out_fn
-{
-    template <class State, class Reducer>
-    constexpr auto operator()(reductor_t<State, Reducer> reductor) const -> output_iterator_t<State, Reducer>
+    auto contains(const key_type& key) const -> bool
     {
-        return { std::move(reductor) };
+        return find(key) != end();
     }
-};
 
-struct reduce_fn
-{
-    template <class State, class Reducer, class Range_0>
-    constexpr auto operator()(reductor_t<State, Reducer> reductor, Range_0&& range_0) const -> State
+    auto operator[](const key_type& key) -> mapped_type&
+    {
+        return try_emplace(key).first->second;
+    }
+
+    template <class... Args>
+    auto try_emplace(const key_type& key, Args&&... args) -> std::pair<iterator, bool>
+    {
+        return try_emplace_hashed(hash(key), key, std::forward<Args>(args)...);
+    }
+
+    template <class... Args>
+    auto try_emplace_hashed(std::size_t hash, const key_type& key, Args&&... args) -> std::pair<iterator, bool>
     {
-        auto it_0 = std::begin(range_0);
-        const auto end_0 = std::end(range_0);
-        for (; it_0 != end_0; ++it_0)
+        if ((m_values.size() + 1) * 4 > m_slots.size() * 3)
+        {
+            rehash(capacity_for(m_values.size() + 1));
+        }
+        const auto mask = m_slots.size() - 1;
+        for (std::size_t pos = hash & mask;; pos = (pos + 1) & mask)
         {
-            if (!reductor(*it_0))
+            slot_t& slot = m_slots[pos];
+            if (slot.index == 0)
             {
-                break;
+                m_values.emplace_back(
+                    std::piecewise_construct,
+                    std::forward_as_tuple(key),
+                    std::forward_as_tuple(std::forward<Args>(args)...));
+                slot = slot_t{ hash, m_values.size() };
+                return { end() - 1, true };
             }
+            if (slot.hash == hash && detail::invoke(m_equal, m_values[slot.index - 1].first, key))
+            {
+                return { begin() + (slot.index - 1), false };
+            }
+        }
+    }
+
+private:
+    struct slot_t
+    {
+        std::size_t hash = 0;
+        std::size_t index = 0;  // 0 for an empty slot, entry index + 1 otherwise
+    };
+
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    static auto capacity_for(size_type count) -> size_type
+    {
+        size_type capacity = 16;
+        while (count * 4 > capacity * 3)
+        {
+            capacity *= 2;
         }
-        return reductor.state;
+        return capacity;
     }
 
-    template <class State, class Reducer, class Range_0, class Range_1>
-    constexpr auto operator()(reductor_t<State, Reducer> reductor, Range_0&& range_0, Range_1&& range_1) const -> State
+    auto find_index(const key_type& key, std::size_t hash) const -> std::size_t
     {
-        auto it_0 = std::begin(range_0);
-        auto it_1 = std::begin(range_1);
-        const auto end_0 = std::end(range_0);
-        const auto end_1 = std::end(range_1);
-        for (; it_0 != end_0 && it_1 != end_1; ++it_0, ++it_1)
+        if (m_slots.empty())
+        {
+            return npos;
+        }
+        const auto mask = m_slots.size() - 1;
+        for (std::size_t pos = hash & mask;; pos = (pos + 1) & mask)
         {
-            if (!reductor(*it_0, *it_1))
+            const slot_t& slot = m_slots[pos];
+            if (slot.index == 0)
             {
-                break;
+                return npos;
+            }
+            if (slot.hash == hash && detail::invoke(m_equal, m_values[slot.index - 1].first, key))
+            {
+                return slot.index - 1;
             }
         }
-        return reductor.state;
     }
 
-    template <class State, class Reducer, class Range_0, class Range_1, class Range_2>
-    constexpr auto operator()(
-        reductor_t<State, Reducer> reductor, Range_0&& range_0, Range_1&& range_1, Range_2&& range_2) const -> State
+    void rehash(size_type capacity)
     {
-        auto it_0 = std::begin(range_0);
-        auto it_1 = std::begin(range_1);
-        auto it_2 = std::begin(range_2);
-        const auto end_0 = std::end(range_0);
-        const auto end_1 = std::end(range_1);
-        const auto end_2 = std::end(range_2);
-        for (; it_0 != end_0 && it_1 != end_1 && it_2 != end_2; ++it_0, ++it_1, ++it_2)
+        std::vector<slot_t> slots(capacity);
+        const auto mask = capacity - 1;
+        for (const slot_t& slot : m_slots)
         {
-            if (!reductor(*it_0, *it_1, *it_2))
+            if (slot.index != 0)
             {
-                break;
+                std::size_t pos = slot.hash & mask;
+                while (slots[pos].index != 0)
+                {
+                    pos = (pos + 1) & mask;
+                }
+                slots[pos] = slot;
             }
         }
-        return reductor.state;
+        m_slots = std::move(slots);
     }
+
+    hasher m_hash = {};
+    key_equal m_equal = {};
+    std::vector<value_type> m_values;
+    std::vector<slot_t> m_slots;
 };
 
-constexpr inline auto reduce = reduce_fn{};
+// Open-addressing hash set, see `flat_hash_map`.
+template <class Key, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>>
+class flat_hash_set
+{
+public:
+    using key_type = Key;
+    using value_type = Key;
+    using size_type = std::size_t;
 
-template <class Range>
-using range_value_t = typename std::decay_t<Range>::value_type;
+    auto size() const -> size_type
+    {
+        return m_map.size();
+    }
 
-struct from_fn
-{
-    template <class Range_0>
-    constexpr auto operator()(Range_0&& range_0) const -> generator_t<range_value_t<Range_0>>
+    auto empty() const -> bool
     {
-        using generator_type = generator_t<range_value_t<Range_0>>;
-        return generator_type(
-            [&](auto yield)
-            {
-                auto it_0 = std::begin(range_0);
-                const auto end_0 = std::end(range_0);
-                for (; it_0 != end_0; ++it_0)
-                {
-                    if (!yield(*it_0))
-                    {
-                        break;
-                    }
-                }
-            });
+        return m_map.empty();
     }
 
-    template <class Range_0, class Range_1>
-    constexpr auto operator()(Range_0&& range_0, Range_1&& range_1) const
-        -> generator_t<range_value_t<Range_0>, range_value_t<Range_1>>
+    void reserve(size_type count)
     {
-        using generator_type = generator_t<range_value_t<Range_0>, range_value_t<Range_1>>;
-        return generator_type(
-            [&](auto yield)
-            {
-                auto it_0 = std::begin(range_0);
-                auto it_1 = std::begin(range_1);
-                const auto end_0 = std::end(range_0);
-                const auto end_1 = std::end(range_1);
-                for (; it_0 != end_0 && it_1 != end_1; ++it_0, ++it_1)
-                {
-                    if (!yield(*it_0, *it_1))
-                    {
-                        break;
-                    }
-                }
-            });
+        m_map.reserve(count);
     }
 
-    template <class Range_0, class Range_1, class Range_2>
-    constexpr auto operator()(Range_0&& range_0, Range_1&& range_1, Range_2&& range_2) const
-        -> generator_t<range_value_t<Range_0>, range_value_t<Range_1>, range_value_t<Range_2>>
+    auto hash(const key_type& key) const -> std::size_t
+    {
+        return m_map.hash(key);
+    }
 
+    auto contains(const key_type& key) const -> bool
     {
-        using generator_type = generator_t<range_value_t<Range_0>, range_value_t<Range_1>, range_value_t<Range_2>>;
-        return generator_type(
-            [&](auto yield)
-            {
-                auto it_0 = std::begin(range_0);
-                auto it_1 = std::begin(range_1);
-                auto it_2 = std::begin(range_2);
-                const auto end_0 = std::end(range_0);
-                const auto end_1 = std::end(range_1);
-                const auto end_2 = std::end(range_2);
-                for (; it_0 != end_0 && it_1 != end_1 && it_2 != end_2; ++it_0, ++it_1, ++it_2)
-                {
-                    if (!yield(*it_0, *it_1, *it_2))
-                    {
-                        break;
-                    }
-                }
-            });
+        return m_map.contains(key);
+    }
+
+    // Returns `true` if the key was not present.
+    auto insert(const key_type& key) -> bool
+    {
+        return m_map.try_emplace(key).second;
+    }
+
+    auto insert_hashed(std::size_t hash, const key_type& key) -> bool
+    {
+        return m_map.try_emplace_hashed(hash, key).second;
     }
+
+private:
+    struct empty_t
+    {
+    };
+
+    flat_hash_map<Key, empty_t, Hash, KeyEqual> m_map;
 };
 
-struct chain_fn
+// Bloom filter over precomputed 64-bit hashes, sized for `expected_items` and `false_positive_rate`. Probe positions
+// are derived by double hashing.
+class bloom_filter
 {
-    template <class Range_0, class Range_1>
-    constexpr auto operator()(Range_0&& range_0, Range_1&& range_1) const
-        -> generator_t<std::common_type_t<range_value_t<Range_0>, range_value_t<Range_1>>>
+public:
+    explicit bloom_filter(std::size_t expected_items = 1024, double false_positive_rate = 0.01)
     {
-        using generator_type = generator_t<std::common_type_t<range_value_t<Range_0>, range_value_t<Range_1>>>;
-        return generator_type(
-            [&](auto yield)
-            {
-                for (auto&& item : range_0)
+        const double ln2 = 0.6931471805599453;
+        const double bits = -static_cast<double>(std::max<std::size_t>(expected_items, 1))
+                            * std::log(std::clamp(false_positive_rate, 1e-9, 0.5)) / (ln2 * ln2);
+        m_words.resize(std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(bits / 64))));
+        m_probes = std::clamp<std::size_t>(
+            static_cast<std::size_t>(std::round(bits / std::max<std::size_t>(expected_items, 1) * ln2)), 1, 32);
+    }
+
+    auto bit_count() const -> std::size_t
+    {
+        return m_words.size() * 64;
+    }
+
+    auto probe_count() const -> std::size_t
+    {
+        return m_probes;
+    }
+
+    auto contains(std::uint64_t hash) const -> bool
+    {
+        for (std::size_t i = 0; i < m_probes; ++i)
+        {
+            const auto bit = position(hash, i);
+            if ((m_words[bit / 64] & (std::uint64_t{ 1 } << (bit % 64))) == 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Returns `true` if the hash was (probably) not present.
+    auto insert(std::uint64_t hash) -> bool
+    {
+        bool inserted = false;
+        for (std::size_t i = 0; i < m_probes; ++i)
+        {
+            const auto bit = position(hash, i);
+            std::uint64_t& word = m_words[bit / 64];
+            const auto mask = std::uint64_t{ 1 } << (bit % 64);
+            inserted |= (word & mask) == 0;
+            word |= mask;
+        }
+        return inserted;
+    }
+
+private:
+    auto position(std::uint64_t hash, std::size_t i) const -> std::size_t
+    {
+        const std::uint64_t h1 = hash & 0xFFFFFFFF;
+        const std::uint64_t h2 = (hash >> 32) | 1;
+        return static_cast<std::size_t>((h1 + i * h2) % bit_count());
+    }
+
+    std::vector<std::uint64_t> m_words;
+    std::size_t m_probes;
+};
+
+namespace detail
+{
+
+constexpr auto count_leading_zeros(std::uint64_t value) -> std::size_t
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return value == 0 ? 64 : static_cast<std::size_t>(__builtin_clzll(value));
+#else
+    std::size_t result = 0;
+    for (std::uint64_t mask = std::uint64_t{ 1 } << 63; mask != 0 && (value & mask) == 0; mask >>= 1)
+    {
+        ++result;
+    }
+    return result;
+#endif
+}
+
+}  // namespace detail
+
+// HyperLogLog sketch with 2^precision one-byte registers. The register index is taken from the top `precision` bits
+// of the 64-bit hash, the register holds the maximal position of the leftmost set bit among the remaining bits.
+class hyperloglog
+{
+public:
+    // `precision` is clamped to [4, 18], i.e. 16 B to 256 KB of registers.
+    explicit hyperloglog(std::size_t precision = 14)
+        : m_precision{ std::clamp<std::size_t>(precision, 4, 18) }
+        , m_registers(std::size_t{ 1 } << m_precision)
+    {
+    }
+
+    auto precision() const -> std::size_t
+    {
+        return m_precision;
+    }
+
+    auto registers() const -> const std::vector<std::uint8_t>&
+    {
+        return m_registers;
+    }
+
+    template <class T>
+    void push(const T& value)
+    {
+        push_hash(detail::mix_hash(std::hash<T>{}(value)));
+    }
+
+    void push_hash(std::uint64_t hash)
+    {
+        const auto index = static_cast<std::size_t>(hash >> (64 - m_precision));
+        const auto rank
+            = static_cast<std::uint8_t>(std::min(detail::count_leading_zeros(hash << m_precision), 64 - m_precision) + 1);
+        m_registers[index] = std::max(m_registers[index], rank);
+    }
+
+    // Register-wise maximum. Throws std::invalid_argument if the sketches have different precisions.
+    void merge(const hyperloglog& other)
+    {
+        if (m_precision != other.m_precision)
+        {
+            throw std::invalid_argument{ "hyperloglog::merge: precision mismatch" };
+        }
+        for (std::size_t i = 0; i < m_registers.size(); ++i)
+        {
+            m_registers[i] = std::max(m_registers[i], other.m_registers[i]);
+        }
+    }
+
+    auto estimate() const -> double
+    {
+        const auto m = static_cast<double>(m_registers.size());
+        double sum = 0.0;
+        std::size_t zeros = 0;
+        for (const std::uint8_t value : m_registers)
+        {
+            sum += std::ldexp(1.0, -static_cast<int>(value));
+            zeros += value == 0 ? 1 : 0;
+        }
+        const double alpha = m_precision == 4   ? 0.673
+                             : m_precision == 5 ? 0.697
+                             : m_precision == 6 ? 0.709
+                                                : 0.7213 / (1.0 + 1.079 / m);
+        const double estimate = alpha * m * m / sum;
+        if (estimate <= 2.5 * m && zeros > 0)
+        {
+            return m * std::log(m / static_cast<double>(zeros));
+        }
+        return estimate;
+    }
+
+private:
+    std::size_t m_precision;
+    std::vector<std::uint8_t> m_registers;
+};
+
+// KLL quantile sketch. Items are buffered in levels of geometrically decreasing capacity; a full level is sorted and
+// every other item (starting at a pseudo-randomly chosen offset) is promoted to the next level with doubled weight.
+// The normalized rank error is roughly `accuracy`.
+template <class T = double, class Compare = std::less<>>
+class quantile_sketch
+{
+public:
+    using value_type = T;
+
+    explicit quantile_sketch(double accuracy = 0.01, Compare compare = {})
+        : m_k{ std::max<std::size_t>(8, static_cast<std::size_t>(std::ceil(2.0 / std::max(accuracy, 1e-6)))) }
+        , m_compare{ std::move(compare) }
+        , m_levels(1)
+    {
+        update_capacities();
+    }
+
+    auto count() const -> std::size_t
+    {
+        return m_count;
+    }
+
+    auto empty() const -> bool
+    {
+        return m_count == 0;
+    }
+
+    // Number of retained items.
+    auto size() const -> std::size_t
+    {
+        return m_size;
+    }
+
+    template <class U>
+    void push(U&& value)
+    {
+        m_levels.front().emplace_back(std::forward<U>(value));
+        ++m_size;
+        ++m_count;
+        compress();
+    }
+
+    void merge(const quantile_sketch& other)
+    {
+        if (m_levels.size() < other.m_levels.size())
+        {
+            m_levels.resize(other.m_levels.size());
+            update_capacities();
+        }
+        for (std::size_t level = 0; level < other.m_levels.size(); ++level)
+        {
+            m_levels[level].insert(m_levels[level].end(), other.m_levels[level].begin(), other.m_levels[level].end());
+        }
+        m_size += other.m_size;
+        m_count += other.m_count;
+        compress();
+    }
+
+    // Item whose rank is approximately `q * count()`, `q` in [0, 1]. Requires a non-empty sketch.
+    auto quantile(double q) const -> T
+    {
+        std::vector<std::pair<const T*, std::uint64_t>> items;
+        items.reserve(m_size);
+        for (std::size_t level = 0; level < m_levels.size(); ++level)
+        {
+            for (const T& value : m_levels[level])
+            {
+                items.emplace_back(&value, std::uint64_t{ 1 } << level);
+            }
+        }
+        std::sort(
+            items.begin(),
+            items.end(),
+            [&](const auto& lhs, const auto& rhs) { return detail::invoke(m_compare, *lhs.first, *rhs.first); });
+        std::uint64_t total = 0;
+        for (const auto& item : items)
+        {
+            total += item.second;
+        }
+        const auto target = static_cast<std::uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) * static_cast<double>(total)));
+        std::uint64_t cumulative = 0;
+        for (const auto& item : items)
+        {
+            cumulative += item.second;
+            if (cumulative >= target)
+            {
+                return *item.first;
+            }
+        }
+        return *items.back().first;
+    }
+
+private:
+    // The capacity of a level shrinks geometrically with its distance from the top level, so the capacities (cached
+    // for `compress`, which runs on every push) are recomputed whenever a level is added.
+    void update_capacities()
+    {
+        m_capacities.resize(m_levels.size());
+        m_total_capacity = 0;
+        for (std::size_t level = 0; level < m_levels.size(); ++level)
+        {
+            const auto depth = static_cast<double>(m_levels.size() - 1 - level);
+            const auto result = std::ceil(static_cast<double>(m_k) * std::pow(2.0 / 3.0, depth));
+            m_capacities[level] = std::max<std::size_t>(2, static_cast<std::size_t>(result));
+            m_total_capacity += m_capacities[level];
+        }
+    }
+
+    void compress()
+    {
+        while (m_size > m_total_capacity)
+        {
+            for (std::size_t level = 0; level < m_levels.size(); ++level)
+            {
+                if (m_levels[level].size() >= m_capacities[level])
                 {
-                    if (!yield(item))
-                    {
-                        return;
-                    }
+                    compact(level);
+                    break;
                 }
-                for (auto&& item : range_1)
+            }
+        }
+    }
+
+    void compact(std::size_t level)
+    {
+        if (level + 1 == m_levels.size())
+        {
+            m_levels.emplace_back();
+            update_capacities();
+        }
+        std::vector<T>& items = m_levels[level];
+        std::vector<T>& next = m_levels[level + 1];
+        std::sort(items.begin(), items.end(), m_compare);
+        const std::size_t pairs = items.size() / 2;
+        m_seed ^= m_seed << 13;
+        m_seed ^= m_seed >> 7;
+        m_seed ^= m_seed << 17;
+        const std::size_t offset = m_seed & 1;
+        for (std::size_t i = 0; i < pairs; ++i)
+        {
+            next.push_back(std::move(items[2 * i + offset]));
+        }
+        items.erase(items.begin(), items.begin() + static_cast<std::ptrdiff_t>(2 * pairs));
+        m_size -= pairs;
+    }
+
+    std::size_t m_k;
+    Compare m_compare;
+    std::vector<std::vector<T>> m_levels;
+    std::vector<std::size_t> m_capacities = {};
+    std::size_t m_total_capacity = 0;
+    std::size_t m_size = 0;
+    std::size_t m_count = 0;
+    std::uint64_t m_seed = 0x9E3779B97F4A7C15ULL;
+};
+
+// Non-owning view of a contiguous sequence.
+template <class T>
+struct span
+{
+    T* m_data = nullptr;
+    std::size_t m_size = 0;
+
+    constexpr auto data() const -> T*
+    {
+        return m_data;
+    }
+
+    constexpr auto size() const -> std::size_t
+    {
+        return m_size;
+    }
+
+    constexpr auto empty() const -> bool
+    {
+        return m_size == 0;
+    }
+
+    constexpr auto begin() const -> T*
+    {
+        return m_data;
+    }
+
+    constexpr auto end() const -> T*
+    {
+        return m_data + m_size;
+    }
+
+    constexpr auto operator[](std::size_t index) const -> T&
+    {
+        return m_data[index];
+    }
+};
+
+// Formats items as lines into an internal buffer which is written to a stream (with a single `write` call) or to a
+// file descriptor whenever it fills up and once more when `flush` is called. Numbers are formatted with `std::to_chars`,
+// other types which are not convertible to `std::string_view` with `operator<<`. Arguments of a multi-argument item are
+// separated by `separator`.
+class line_writer
+{
+public:
+    line_writer(std::ostream& stream, std::string separator = " ", std::size_t buffer_size = 1 << 16)
+        : m_stream{ &stream }
+        , m_separator{ std::move(separator) }
+        , m_buffer_size{ std::max<std::size_t>(buffer_size, 1) }
+    {
+    }
+
+#ifdef TRX_HAS_POSIX
+    line_writer(int fd, std::string separator = " ", std::size_t buffer_size = 1 << 16)
+        : m_fd{ fd }
+        , m_separator{ std::move(separator) }
+        , m_buffer_size{ std::max<std::size_t>(buffer_size, 1) }
+    {
+    }
+#endif  // TRX_HAS_POSIX
+
+    auto count() const -> std::size_t
+    {
+        return m_count;
+    }
+
+    template <class Arg, class... Args>
+    void push(const Arg& arg, const Args&... args)
+    {
+        if (m_buffer.capacity() < m_buffer_size)
+        {
+            m_buffer.reserve(m_buffer_size + 64);
+        }
+        append(arg);
+        ((m_buffer += m_separator, append(args)), ...);
+        m_buffer += '\n';
+        ++m_count;
+        if (m_buffer.size() >= m_buffer_size)
+        {
+            flush();
+        }
+    }
+
+    // Writes the buffered lines. Throws std::system_error if writing to a file descriptor fails.
+    void flush()
+    {
+        if (m_buffer.empty())
+        {
+            return;
+        }
+        if (m_stream)
+        {
+            m_stream->write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+        }
+#ifdef TRX_HAS_POSIX
+        else
+        {
+            for (std::size_t offset = 0; offset < m_buffer.size();)
+            {
+                const auto written = ::write(m_fd, m_buffer.data() + offset, m_buffer.size() - offset);
+                if (written < 0)
                 {
-                    if (!yield(item))
+                    if (errno == EINTR)
                     {
-                        return;
+                        continue;
                     }
+                    throw std::system_error{ errno, std::generic_category(), "write_lines" };
                 }
-            });
+                offset += static_cast<std::size_t>(written);
+            }
+        }
+#endif  // TRX_HAS_POSIX
+        m_buffer.clear();
+    }
+
+private:
+    template <class T>
+    void append(const T& value)
+    {
+        if constexpr (std::is_same_v<T, bool>)
+        {
+            m_buffer += value ? "true" : "false";
+        }
+        else if constexpr (std::is_same_v<T, char>)
+        {
+            m_buffer += value;
+        }
+        else if constexpr (std::is_arithmetic_v<T>)
+        {
+            std::array<char, 64> chars;
+            const auto result = std::to_chars(chars.data(), chars.data() + chars.size(), value);
+            m_buffer.append(chars.data(), result.ptr);
+        }
+        else if constexpr (std::is_convertible_v<const T&, std::string_view>)
+        {
+            m_buffer += std::string_view{ value };
+        }
+        else
+        {
+            std::ostringstream stream;
+            stream << value;
+            m_buffer += stream.str();
+        }
+    }
+
+    std::ostream* m_stream = nullptr;
+    int m_fd = -1;
+    std::string m_separator;
+    std::size_t m_buffer_size;
+    std::string m_buffer = {};
+    std::size_t m_count = 0;
+};
+
+#ifdef TRX_HAS_POSIX
+// Reads consecutive blocks of a file descriptor, starting at its current offset, into two alternating buffers: while
+// the caller processes the current block, a background thread reads the next one. Seekable descriptors are read with
+// `pread` (leaving the offset unchanged) with `posix_fadvise` hints of sequential access, filling each block completely
+// unless the input ends; pipes and sockets with `read`, returning a block as soon as some data arrived. The descriptor
+// is not closed. The destructor stops the background thread: a wait for input on a pipe or socket is interrupted
+// through a wakeup pipe, while a `pread` in progress is waited for.
+class block_reader
+{
+public:
+    explicit block_reader(int fd, std::size_t block_size = 1 << 20)
+        : m_fd{ fd }
+        , m_block_size{ std::max<std::size_t>(block_size, 1) }
+        , m_buffers{ std::vector<char>(m_block_size), std::vector<char>(m_block_size) }
+    {
+        const auto offset = ::lseek(fd, 0, SEEK_CUR);
+        m_seekable = offset >= 0;
+        m_offset = m_seekable ? offset : 0;
+        if (!m_seekable && ::pipe(m_wakeup) != 0)
+        {
+            throw std::system_error{ errno, std::generic_category(), "read_blocks" };
+        }
+#ifdef POSIX_FADV_SEQUENTIAL
+        if (m_seekable)
+        {
+            ::posix_fadvise(fd, m_offset, 0, POSIX_FADV_SEQUENTIAL);
+        }
+#endif  // POSIX_FADV_SEQUENTIAL
+        try
+        {
+            m_thread = std::thread{ [this] { prefetch(); } };
+        }
+        catch (...)
+        {
+            if (!m_seekable)
+            {
+                ::close(m_wakeup[0]);
+                ::close(m_wakeup[1]);
+            }
+            throw;
+        }
+    }
+
+    block_reader(const block_reader&) = delete;
+    block_reader& operator=(const block_reader&) = delete;
+
+    ~block_reader()
+    {
+        {
+            std::lock_guard<std::mutex> lock{ m_mutex };
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+        if (!m_seekable)
+        {
+            const char byte = 0;
+            while (::write(m_wakeup[1], &byte, 1) < 0 && errno == EINTR)
+            {
+            }
+        }
+        m_thread.join();
+        if (!m_seekable)
+        {
+            ::close(m_wakeup[0]);
+            ::close(m_wakeup[1]);
+        }
+    }
+
+    // Returns the next block, which stays valid until the following call; an empty block at the end of the input.
+    // Throws std::system_error if reading fails.
+    auto next() -> span<const char>
+    {
+        if (m_done)
+        {
+            return {};
+        }
+        std::unique_lock<std::mutex> lock{ m_mutex };
+        m_wake.wait(lock, [&] { return m_filled; });
+        m_filled = false;
+        if (m_error != 0)
+        {
+            m_done = true;
+            throw std::system_error{ m_error, std::generic_category(), "read_blocks" };
+        }
+        const span<const char> block{ m_buffers[m_back].data(), m_size };
+        m_back ^= 1;
+        m_done = m_end;
+        if (!m_done)
+        {
+            m_requested = true;
+            lock.unlock();
+            m_wake.notify_all();
+        }
+        return block;
+    }
+
+private:
+    void prefetch()
+    {
+        while (true)
+        {
+            std::size_t back = 0;
+            {
+                std::unique_lock<std::mutex> lock{ m_mutex };
+                m_wake.wait(lock, [&] { return m_requested || m_stopping; });
+                if (m_stopping)
+                {
+                    return;
+                }
+                m_requested = false;
+                back = m_back;
+            }
+            std::size_t size = 0;
+            int error = 0;
+            bool end = false;
+            while (size < m_block_size && !end && error == 0 && (m_seekable || size == 0))
+            {
+                if (stopping() || (!m_seekable && !wait_readable()))
+                {
+                    return;
+                }
+                const auto count = read(m_buffers[back].data() + size, m_block_size - size);
+                if (count < 0 && errno != EINTR)
+                {
+                    error = errno;
+                }
+                size += count > 0 ? static_cast<std::size_t>(count) : 0;
+                end = count == 0;
+            }
+            {
+                std::lock_guard<std::mutex> lock{ m_mutex };
+                m_size = size;
+                m_error = error;
+                m_end = end || size == 0;
+                m_filled = true;
+            }
+            m_wake.notify_all();
+        }
+    }
+
+    auto stopping() -> bool
+    {
+        std::lock_guard<std::mutex> lock{ m_mutex };
+        return m_stopping;
+    }
+
+    // Waits until the descriptor is readable (or at its end); false if the reader is being destroyed.
+    auto wait_readable() -> bool
+    {
+        ::pollfd fds[] = { { m_fd, POLLIN, 0 }, { m_wakeup[0], POLLIN, 0 } };
+        while (::poll(fds, 2, -1) < 0 && errno == EINTR)
+        {
+        }
+        return fds[1].revents == 0;
+    }
+
+    auto read(char* data, std::size_t size) -> ::ssize_t
+    {
+        if (!m_seekable)
+        {
+            return ::read(m_fd, data, size);
+        }
+#ifdef POSIX_FADV_WILLNEED
+        ::posix_fadvise(
+            m_fd, m_offset + static_cast<::off_t>(size), static_cast<::off_t>(m_block_size), POSIX_FADV_WILLNEED);
+#endif  // POSIX_FADV_WILLNEED
+        const auto count = ::pread(m_fd, data, size, m_offset);
+        m_offset += count > 0 ? count : 0;
+        return count;
+    }
+
+    int m_fd;
+    std::size_t m_block_size;
+    std::vector<char> m_buffers[2];
+    bool m_seekable = false;
+    ::off_t m_offset = 0;
+    // Pipe written to by the destructor to interrupt a wait for input on a non-seekable descriptor.
+    int m_wakeup[2] = { -1, -1 };
+    std::mutex m_mutex = {};
+    std::condition_variable m_wake = {};
+    // Index of the buffer being filled by the background thread (or filled and not yet returned).
+    std::size_t m_back = 0;
+    std::size_t m_size = 0;
+    int m_error = 0;
+    bool m_requested = true;
+    bool m_filled = false;
+    bool m_end = false;
+    bool m_done = false;
+    bool m_stopping = false;
+    std::thread m_thread = {};
+};
+#endif  // TRX_HAS_POSIX
+
+// Columnar file format. All values are stored in native byte order:
+//   header: "TRXC", u32 version, u32 column count, u32 rows per block, u32 flags (bit 0: block statistics),
+//           one u8 `column_type` per column
+//   block:  u32 row count, then for each column: [min, max] if statistics are enabled, followed by the values
+// Blocks are self-delimiting, so the file can be written in a single pass.
+enum class column_type : std::uint8_t
+{
+    i8,
+    u8,
+    i16,
+    u16,
+    i32,
+    u32,
+    i64,
+    u64,
+    f32,
+    f64
+};
+
+namespace detail
+{
+
+template <class T>
+constexpr auto column_type_of() -> column_type
+{
+    static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>, "columns must be of fixed-width numeric types");
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        static_assert(sizeof(T) == 4 || sizeof(T) == 8, "unsupported floating point type");
+        return sizeof(T) == 4 ? column_type::f32 : column_type::f64;
+    }
+    else
+    {
+        constexpr std::size_t log2_size = sizeof(T) == 1 ? 0 : sizeof(T) == 2 ? 1 : sizeof(T) == 4 ? 2 : 3;
+        return static_cast<column_type>(2 * log2_size + (std::is_signed_v<T> ? 0 : 1));
+    }
+}
+
+constexpr auto column_width(column_type type) -> std::size_t
+{
+    constexpr std::size_t widths[] = { 1, 1, 2, 2, 4, 4, 8, 8, 4, 8 };
+    return widths[static_cast<std::size_t>(type)];
+}
+
+constexpr inline char column_magic[4] = { 'T', 'R', 'X', 'C' };
+constexpr inline std::uint32_t column_version = 1;
+
+template <class T>
+auto load(const char* data) -> T
+{
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+}  // namespace detail
+
+// Closed range of values of a column; used to skip blocks and rows when reading a columnar file.
+template <class T>
+struct column_range
+{
+    std::size_t column;
+    T min;
+    T max;
+};
+
+// State of the columnar file writer. Rows are buffered column-wise and written as one block per `block_rows` rows;
+// `flush` writes the remaining rows (and the header if no block was written yet). Throws std::ios_base::failure if
+// writing to the stream fails.
+template <class... Ts>
+class column_writer
+{
+public:
+    column_writer(std::ostream& stream, std::size_t block_rows, bool statistics)
+        : m_stream{ &stream }
+        , m_block_rows{ std::max<std::size_t>(block_rows, 1) }
+        , m_statistics{ statistics }
+    {
+        if (m_block_rows > std::numeric_limits<std::uint32_t>::max())
+        {
+            throw std::invalid_argument{ "write_columns: block_rows must fit in 32 bits" };
+        }
+    }
+
+    auto count() const -> std::size_t
+    {
+        return m_count;
+    }
+
+    void push(const Ts&... values)
+    {
+        push_values(std::index_sequence_for<Ts...>{}, values...);
+    }
+
+    void push(const std::tuple<Ts...>& values)
+    {
+        std::apply([&](const Ts&... args) { push(args...); }, values);
+    }
+
+    void flush()
+    {
+        write_header();
+        if (!std::get<0>(m_columns).empty())
+        {
+            write_block(std::index_sequence_for<Ts...>{});
+        }
+        m_stream->flush();
+        check_stream();
+    }
+
+private:
+    template <std::size_t... I>
+    void push_values(std::index_sequence<I...>, const Ts&... values)
+    {
+        (std::get<I>(m_columns).push_back(values), ...);
+        ++m_count;
+        if (std::get<0>(m_columns).size() >= m_block_rows)
+        {
+            write_header();
+            write_block(std::index_sequence_for<Ts...>{});
+        }
+    }
+
+    template <class T>
+    void write_raw(const T* data, std::size_t count)
+    {
+        m_stream->write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(count * sizeof(T)));
+    }
+
+    void write_header()
+    {
+        if (m_header_written)
+        {
+            return;
+        }
+        const std::uint32_t fields[]
+            = { detail::column_version, sizeof...(Ts), static_cast<std::uint32_t>(m_block_rows), m_statistics ? 1u : 0u };
+        const column_type types[] = { detail::column_type_of<Ts>()... };
+        write_raw(detail::column_magic, 4);
+        write_raw(fields, 4);
+        write_raw(types, sizeof...(Ts));
+        check_stream();
+        m_header_written = true;
+    }
+
+    template <std::size_t... I>
+    void write_block(std::index_sequence<I...>)
+    {
+        const auto rows = static_cast<std::uint32_t>(std::get<0>(m_columns).size());
+        write_raw(&rows, 1);
+        (write_column(std::get<I>(m_columns)), ...);
+        check_stream();
+    }
+
+    void check_stream() const
+    {
+        if (!*m_stream)
+        {
+            throw std::ios_base::failure{ "write_columns: writing to the stream failed" };
+        }
+    }
+
+    template <class T>
+    void write_column(std::vector<T>& values)
+    {
+        if (m_statistics)
+        {
+            // NaNs match no range and are left out of the statistics; a block of NaNs only gets NaN statistics, which
+            // never cause it to be skipped.
+            const auto is_number = [](const T& value) { return !(value != value); };
+            const auto first = std::find_if(values.begin(), values.end(), is_number);
+            T min = first != values.end() ? *first : values.front();
+            T max = min;
+            for (auto it = first; it != values.end(); ++it)
+            {
+                if (is_number(*it))
+                {
+                    min = std::min(min, *it);
+                    max = std::max(max, *it);
+                }
+            }
+            write_raw(&min, 1);
+            write_raw(&max, 1);
+        }
+        write_raw(values.data(), values.size());
+        values.clear();
+    }
+
+    std::ostream* m_stream;
+    std::size_t m_block_rows;
+    bool m_statistics;
+    bool m_header_written = false;
+    std::size_t m_count = 0;
+    std::tuple<std::vector<Ts>...> m_columns = {};
+};
+
+// Observer side of a cancellation_source. A token is stop-requested once its source (or any parent source) was
+// cancelled or its deadline passed. A default-constructed token is never stop-requested.
+class cancellation_token
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    cancellation_token() = default;
+
+    auto stop_requested() const -> bool
+    {
+        for (const state_t* state = m_state.get(); state; state = state->parent.get())
+        {
+            if (state->cancelled.load(std::memory_order_relaxed))
+            {
+                return true;
+            }
+        }
+        return m_state && m_state->deadline != clock::time_point::max() && clock::now() >= m_state->deadline;
+    }
+
+    // The earliest deadline of the token and its parents, or time_point::max().
+    auto deadline() const -> clock::time_point
+    {
+        return m_state ? m_state->deadline : clock::time_point::max();
+    }
+
+private:
+    struct state_t
+    {
+        std::atomic<bool> cancelled = false;
+        clock::time_point deadline = clock::time_point::max();
+        std::shared_ptr<const state_t> parent = {};
+    };
+
+    explicit cancellation_token(std::shared_ptr<const state_t> state) : m_state{ std::move(state) }
+    {
+    }
+
+    std::shared_ptr<const state_t> m_state = {};
+
+    friend class cancellation_source;
+};
+
+// Thread-safe trigger of cancellation_tokens, optionally with a deadline. A source created from a parent token is
+// cancelled together with the parent and inherits its deadline if it is earlier, which lets a request-scoped deadline
+// propagate to the stages started on behalf of the request.
+class cancellation_source
+{
+public:
+    using clock = cancellation_token::clock;
+
+    cancellation_source() : m_state{ std::make_shared<state_t>() }
+    {
+    }
+
+    explicit cancellation_source(clock::time_point deadline, const cancellation_token& parent = {})
+        : cancellation_source{ parent }
+    {
+        m_state->deadline = std::min(m_state->deadline, deadline);
+    }
+
+    explicit cancellation_source(clock::duration timeout, const cancellation_token& parent = {})
+        : cancellation_source{ clock::now() + timeout, parent }
+    {
+    }
+
+    explicit cancellation_source(const cancellation_token& parent) : cancellation_source{}
+    {
+        m_state->parent = parent.m_state;
+        m_state->deadline = parent.deadline();
+    }
+
+    void cancel() const
+    {
+        m_state->cancelled.store(true, std::memory_order_relaxed);
+    }
+
+    auto stop_requested() const -> bool
+    {
+        return token().stop_requested();
+    }
+
+    auto token() const -> cancellation_token
+    {
+        return cancellation_token{ m_state };
+    }
+
+private:
+    using state_t = cancellation_token::state_t;
+
+    std::shared_ptr<state_t> m_state;
+};
+
+// Result of a shard reductor: the state of each shard and the number of items routed to it.
+template <class State>
+struct sharded
+{
+    std::vector<State> states;
+    std::vector<std::size_t> counts;
+};
+
+// Result of a time window: the state of a reductor over the items with timestamps in [start, end).
+template <class Timestamp, class State>
+struct time_window
+{
+    Timestamp start;
+    Timestamp end;
+    State state;
+};
+
+// Count, mean, variance, minimum and maximum computed in a single pass with Welford's update. Partial results are
+// combined with Chan's formula, which is also used for contiguous blocks of values: a block is reduced with two
+// branch-free (vectorizable) passes and then merged.
+class running_stats
+{
+public:
+    auto count() const -> std::size_t
+    {
+        return m_count;
+    }
+
+    auto mean() const -> double
+    {
+        return m_mean;
+    }
+
+    // Population variance.
+    auto variance() const -> double
+    {
+        return m_count > 0 ? m_m2 / static_cast<double>(m_count) : 0.0;
+    }
+
+    auto sample_variance() const -> double
+    {
+        return m_count > 1 ? m_m2 / static_cast<double>(m_count - 1) : 0.0;
+    }
+
+    auto stddev() const -> double
+    {
+        return std::sqrt(variance());
+    }
+
+    auto min() const -> double
+    {
+        return m_min;
+    }
+
+    auto max() const -> double
+    {
+        return m_max;
+    }
+
+    template <class T, std::enable_if_t<std::is_arithmetic_v<T>, int> = 0>
+    void push(T value)
+    {
+        const auto x = static_cast<double>(value);
+        ++m_count;
+        const double delta = x - m_mean;
+        m_mean += delta / static_cast<double>(m_count);
+        m_m2 += delta * (x - m_mean);
+        m_min = std::min(m_min, x);
+        m_max = std::max(m_max, x);
+    }
+
+    template <class Range, class Ptr = decltype(std::data(std::declval<const Range&>()))>
+    auto push(const Range& range) -> std::enable_if_t<std::is_arithmetic_v<std::remove_pointer_t<Ptr>>>
+    {
+        push_block(std::data(range), std::size(range));
+    }
+
+    template <class T>
+    void push_block(const T* data, std::size_t size)
+    {
+        constexpr std::size_t block_size = 256;
+        for (std::size_t offset = 0; offset < size; offset += block_size)
+        {
+            const T* block = data + offset;
+            const std::size_t n = std::min(block_size, size - offset);
+            double sum = 0.0;
+            double min = static_cast<double>(block[0]);
+            double max = min;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                const auto x = static_cast<double>(block[i]);
+                sum += x;
+                min = x < min ? x : min;
+                max = x > max ? x : max;
+            }
+            const double mean = sum / static_cast<double>(n);
+            double m2 = 0.0;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                const double delta = static_cast<double>(block[i]) - mean;
+                m2 += delta * delta;
+            }
+            merge(n, mean, m2, min, max);
+        }
+    }
+
+    void merge(const running_stats& other)
+    {
+        merge(other.m_count, other.m_mean, other.m_m2, other.m_min, other.m_max);
+    }
+
+private:
+    void merge(std::size_t count, double mean, double m2, double min, double max)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+        const auto total = static_cast<double>(m_count + count);
+        const double delta = mean - m_mean;
+        m_m2 += m2 + delta * delta * static_cast<double>(m_count) * static_cast<double>(count) / total;
+        m_mean += delta * static_cast<double>(count) / total;
+        m_count += count;
+        m_min = std::min(m_min, min);
+        m_max = std::max(m_max, max);
+    }
+
+    std::size_t m_count = 0;
+    double m_mean = 0.0;
+    double m_m2 = 0.0;
+    double m_min = std::numeric_limits<double>::infinity();
+    double m_max = -std::numeric_limits<double>::infinity();
+};
+
+// Hash map split into 2^partition_bits independent flat_hash_maps selected by the high bits of the key hash, so that
+// partitions can be built and merged in parallel.
+template <class Key, class Value, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>>
+class partitioned_hash_map
+{
+public:
+    using partition_type = flat_hash_map<Key, Value, Hash, KeyEqual>;
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = typename partition_type::value_type;
+    using size_type = std::size_t;
+
+    template <class Partitions, class PartitionIterator>
+    struct iterator_base
+    {
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename partition_type::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = decltype(*std::declval<PartitionIterator>());
+        using pointer = std::add_pointer_t<reference>;
+
+        Partitions* m_partitions = nullptr;
+        std::size_t m_partition = 0;
+        PartitionIterator m_it = {};
+
+        auto operator*() const -> reference
+        {
+            return *m_it;
+        }
+
+        auto operator->() const -> pointer
+        {
+            return std::addressof(*m_it);
+        }
+
+        auto operator++() -> iterator_base&
+        {
+            ++m_it;
+            skip_empty();
+            return *this;
+        }
+
+        auto operator++(int) -> iterator_base
+        {
+            iterator_base result = *this;
+            ++(*this);
+            return result;
+        }
+
+        void skip_empty()
+        {
+            while (m_it == (*m_partitions)[m_partition].end() && m_partition + 1 < m_partitions->size())
+            {
+                m_it = (*m_partitions)[++m_partition].begin();
+            }
+        }
+
+        friend auto operator==(const iterator_base& lhs, const iterator_base& rhs) -> bool
+        {
+            return lhs.m_partition == rhs.m_partition && lhs.m_it == rhs.m_it;
+        }
+
+        friend auto operator!=(const iterator_base& lhs, const iterator_base& rhs) -> bool
+        {
+            return !(lhs == rhs);
+        }
+    };
+
+    using iterator = iterator_base<std::vector<partition_type>, typename partition_type::iterator>;
+    using const_iterator = iterator_base<const std::vector<partition_type>, typename partition_type::const_iterator>;
+
+    explicit partitioned_hash_map(std::size_t partition_bits = 0)
+        : m_partition_bits{ partition_bits }
+        , m_partitions(std::size_t{ 1 } << partition_bits)
+    {
+    }
+
+    auto partition_bits() const -> std::size_t
+    {
+        return m_partition_bits;
+    }
+
+    auto partitions() -> std::vector<partition_type>&
+    {
+        return m_partitions;
+    }
+
+    auto partitions() const -> const std::vector<partition_type>&
+    {
+        return m_partitions;
+    }
+
+    auto partition_of(std::size_t hash) const -> std::size_t
+    {
+        return m_partition_bits == 0 ? 0 : hash >> (sizeof(std::size_t) * 8 - m_partition_bits);
+    }
+
+    auto hash(const key_type& key) const -> std::size_t
+    {
+        return m_partitions.front().hash(key);
+    }
+
+    auto begin() -> iterator
+    {
+        return make_iterator<iterator>(m_partitions, 0, m_partitions.front().begin());
+    }
+
+    auto end() -> iterator
+    {
+        return make_iterator<iterator>(m_partitions, m_partitions.size() - 1, m_partitions.back().end());
+    }
+
+    auto begin() const -> const_iterator
+    {
+        return make_iterator<const_iterator>(m_partitions, 0, m_partitions.front().begin());
+    }
+
+    auto end() const -> const_iterator
+    {
+        return make_iterator<const_iterator>(m_partitions, m_partitions.size() - 1, m_partitions.back().end());
+    }
+
+    auto size() const -> size_type
+    {
+        size_type result = 0;
+        for (const partition_type& partition : m_partitions)
+        {
+            result += partition.size();
+        }
+        return result;
+    }
+
+    auto empty() const -> bool
+    {
+        return size() == 0;
+    }
+
+    auto find(const key_type& key) -> iterator
+    {
+        const auto h = hash(key);
+        const auto p = partition_of(h);
+        const auto it = m_partitions[p].find(key, h);
+        return it != m_partitions[p].end() ? make_iterator<iterator>(m_partitions, p, it) : end();
+    }
+
+    auto find(const key_type& key) const -> const_iterator
+    {
+        const auto h = hash(key);
+        const auto p = partition_of(h);
+        const auto it = m_partitions[p].find(key, h);
+        return it != m_partitions[p].end() ? make_iterator<const_iterator>(m_partitions, p, it) : end();
+    }
+
+    auto contains(const key_type& key) const -> bool
+    {
+        return find(key) != end();
+    }
+
+private:
+    template <class Iterator, class Partitions, class PartitionIterator>
+    static auto make_iterator(Partitions& partitions, std::size_t partition, PartitionIterator it) -> Iterator
+    {
+        Iterator result{ &partitions, partition, it };
+        result.skip_empty();
+        return result;
+    }
+
+    std::size_t m_partition_bits;
+    std::vector<partition_type> m_partitions;
+};
+
+namespace detail
+{
+
+struct identity_fn
+{
+    template <class T>
+    constexpr auto operator()(T&& arg) const -> T&&
+    {
+        return std::forward<T>(arg);
+    }
+};
+
+}  // namespace detail
+
+// Keeps at most `capacity` values which are the greatest according to `compare` applied to `key(value)`. The root of
+// the heap is the smallest retained value, so values which do not exceed it are rejected without touching the heap.
+template <class T, class Key = detail::identity_fn, class Compare = std::less<>>
+class bounded_heap
+{
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+    explicit bounded_heap(size_type capacity, Key key = {}, Compare compare = {})
+        : m_capacity{ capacity }
+        , m_key{ std::move(key) }
+        , m_compare{ std::move(compare) }
+    {
+        m_values.reserve(capacity);
+    }
+
+    template <class U>
+    void push(U&& value)
+    {
+        if (m_values.size() < m_capacity)
+        {
+            m_values.emplace_back(std::forward<U>(value));
+            std::push_heap(m_values.begin(), m_values.end(), heap_compare());
+            return;
+        }
+        if (m_capacity == 0
+            || !detail::invoke(m_compare, detail::invoke(m_key, m_values.front()), detail::invoke(m_key, value)))
+        {
+            return;
+        }
+        std::pop_heap(m_values.begin(), m_values.end(), heap_compare());
+        m_values.back() = std::forward<U>(value);
+        std::push_heap(m_values.begin(), m_values.end(), heap_compare());
+    }
+
+    void merge(const bounded_heap& other)
+    {
+        for (const T& value : other.m_values)
+        {
+            push(value);
+        }
+    }
+
+    void merge(bounded_heap&& other)
+    {
+        for (T& value : other.m_values)
+        {
+            push(std::move(value));
+        }
+    }
+
+    // Smallest retained value, i.e. the one a new value has to exceed once the heap is full.
+    auto threshold() const -> const T&
+    {
+        return m_values.front();
+    }
+
+    auto capacity() const -> size_type
+    {
+        return m_capacity;
+    }
+
+    auto size() const -> size_type
+    {
+        return m_values.size();
+    }
+
+    auto empty() const -> bool
+    {
+        return m_values.empty();
+    }
+
+    auto begin() const -> const_iterator
+    {
+        return m_values.begin();
+    }
+
+    auto end() const -> const_iterator
+    {
+        return m_values.end();
+    }
+
+    // Retained values, greatest first.
+    auto sorted() const& -> std::vector<T>
+    {
+        return bounded_heap{ *this }.sorted();
+    }
+
+    auto sorted() && -> std::vector<T>
+    {
+        std::sort_heap(m_values.begin(), m_values.end(), heap_compare());
+        return std::move(m_values);
+    }
+
+private:
+    auto heap_compare() const
+    {
+        return [this](const T& lhs, const T& rhs) -> bool
+        { return detail::invoke(m_compare, detail::invoke(m_key, rhs), detail::invoke(m_key, lhs)); };
+    }
+
+    size_type m_capacity;
+    Key m_key;
+    Compare m_compare;
+    std::vector<T> m_values;
+};
+
+namespace detail
+{
+
+template <class Callable>
+using return_type_t = typename decltype(std::function{ std::declval<Callable>() })::result_type;
+
+template <class T, class = void>
+struct is_generator_impl : std::false_type
+{
+};
+
+template <class YieldFn>
+struct is_generator_impl<std::function<void(YieldFn)>, std::enable_if_t<std::is_convertible_v<return_type_t<YieldFn>, bool>>>
+    : std::true_type
+{
+};
+
+template <class T>
+struct is_reductor_impl : std::false_type
+{
+};
+
+template <class S, class R>
+struct is_reductor_impl<reductor_t<S, R>> : std::true_type
+{
+};
+
+template <class T, class = void>
+struct is_range_impl : std::false_type
+{
+};
+
+template <class T>
+struct is_range_impl<T, std::void_t<decltype(std::begin(std::declval<T&>())), decltype(std::end(std::declval<T&>()))>>
+    : std::true_type
+{
+};
+
+template <class T, class = void>
+struct is_sized_impl : std::false_type
+{
+};
+
+template <class T>
+struct is_sized_impl<T, std::void_t<decltype(std::size(std::declval<const T&>()))>> : std::true_type
+{
+};
+
+template <class T>
+struct is_transducer_impl
+{
+    static constexpr bool value = !is_generator_impl<T>::value && !is_reductor_impl<T>::value && !is_range_impl<T>::value;
+};
+
+}  // namespace detail
+
+template <class Reducer, class State, class RunState, class... Args>
+constexpr auto invoke_reducer(const Reducer& reducer, State& state, RunState& run_state, Args&&... args) -> bool
+{
+    if constexpr (has_run_state_v<Reducer>)
+    {
+        return reducer(state, run_state, std::forward<Args>(args)...);
+    }
+    else
+    {
+        return detail::invoke(reducer, state, std::forward<Args>(args)...);
+    }
+}
+
+template <class State, class Reducer>
+template <class... Args>
+constexpr auto reductor_t<State, Reducer>::operator()(Args&&... args) -> bool
+{
+    return invoke_reducer(reducer, state, run_state, std::forward<Args>(args)...);
+}
+
+namespace detail
+{
+
+template <class Reducer, class Args, class = void>
+struct has_complete_impl : std::false_type
+{
+};
+
+template <class Reducer, class... Args>
+struct has_complete_impl<
+    Reducer,
+    std::tuple<Args...>,
+    std::void_t<decltype(std::declval<const Reducer&>().complete(std::declval<Args>()...))>> : std::true_type
+{
+};
+
+}  // namespace detail
+
+// Signals the end of the input. Reducers may define `complete(State&, run_state_type&)` (or `complete(State&)` if they
+// have no run state) to flush buffered items or finalize the state; transducers forward it to the next reducer.
+template <class Reducer, class State, class RunState>
+constexpr void complete_reducer(const Reducer& reducer, State& state, RunState& run_state)
+{
+    if constexpr (has_run_state_v<Reducer>)
+    {
+        if constexpr (detail::has_complete_impl<Reducer, std::tuple<State&, RunState&>>::value)
+        {
+            reducer.complete(state, run_state);
+        }
+    }
+    else if constexpr (detail::has_complete_impl<Reducer, std::tuple<State&>>::value)
+    {
+        reducer.complete(state);
+    }
+}
+
+namespace detail
+{
+
+template <class Reducer, class Args, class = void>
+struct has_reserve_impl : std::false_type
+{
+};
+
+template <class Reducer, class... Args>
+struct has_reserve_impl<
+    Reducer,
+    std::tuple<Args...>,
+    std::void_t<decltype(std::declval<const Reducer&>().reserve(std::declval<Args>()...))>> : std::true_type
+{
+};
+
+}  // namespace detail
+
+// Passes the number of items about to be pushed, if the executor knows it. Reducers may define
+// `reserve(State&, run_state_type&, std::size_t)` (or `reserve(State&, std::size_t)`) to preallocate their state;
+// transducers which pass exactly one item per input item forward it to the next reducer.
+template <class Reducer, class State, class RunState>
+constexpr void reserve_reducer(const Reducer& reducer, State& state, RunState& run_state, std::size_t size)
+{
+    if constexpr (has_run_state_v<Reducer>)
+    {
+        if constexpr (detail::has_reserve_impl<Reducer, std::tuple<State&, RunState&, std::size_t>>::value)
+        {
+            reducer.reserve(state, run_state, size);
+        }
+    }
+    else if constexpr (detail::has_reserve_impl<Reducer, std::tuple<State&, std::size_t>>::value)
+    {
+        reducer.reserve(state, size);
+    }
+}
+
+namespace detail
+{
+
+// Reducers may define `push_range(State&, const Range&)` to reduce a whole range passed to `|=` at once (e.g. a
+// contiguous range of numbers with vectorizable loops) instead of item by item.
+template <class Reducer, class State, class Range, class = void>
+struct has_push_range_impl : std::false_type
+{
+};
+
+template <class Reducer, class State, class Range>
+struct has_push_range_impl<
+    Reducer,
+    State,
+    Range,
+    std::void_t<decltype(std::declval<const Reducer&>().push_range(std::declval<State&>(), std::declval<const Range&>()))>>
+    : std::true_type
+{
+};
+
+template <class State, class Reducer>
+struct run_t
+{
+    State state;
+    const Reducer& reducer;
+    run_state_t<Reducer> run_state = {};
+
+    template <class... Args>
+    constexpr auto operator()(Args&&... args) -> bool
+    {
+        return invoke_reducer(reducer, state, run_state, std::forward<Args>(args)...);
+    }
+
+    constexpr void reserve(std::size_t size)
+    {
+        reserve_reducer(reducer, state, run_state, size);
+    }
+
+    constexpr void complete()
+    {
+        complete_reducer(reducer, state, run_state);
+    }
+};
+
+struct start_fn
+{
+    template <class State, class Reducer>
+    constexpr auto operator()(const reductor_t<State, Reducer>& reductor) const -> run_t<State, Reducer>
+    {
+        return { reductor.state, reductor.reducer };
+    }
+
+    template <class State, class Reducer>
+    constexpr auto operator()(reductor_t<State, Reducer>&& reductor) const -> run_t<State, Reducer>
+    {
+        return { std::move(reductor.state), reductor.reducer };
+    }
+};
+
+static constexpr inline auto start = start_fn{};
+
+// Runs func(0), ..., func(count - 1) concurrently, func(0) on the calling thread. The first exception is rethrown.
+template <class Func>
+void parallel_for(std::size_t count, Func&& func)
+{
+    std::vector<std::exception_ptr> errors(count);
+    auto guarded = [&](std::size_t index)
+    {
+        try
+        {
+            func(index);
+        }
+        catch (...)
+        {
+            errors[index] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(count);
+    for (std::size_t index = 1; index < count; ++index)
+    {
+        threads.emplace_back(guarded, index);
+    }
+    if (count > 0)
+    {
+        guarded(0);
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    for (const std::exception_ptr& error : errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+inline auto worker_count(std::size_t workers) -> std::size_t
+{
+    return workers != 0 ? workers : std::max<std::size_t>(1, std::thread::hardware_concurrency());
+}
+
+// Number of chunks per worker used by the load-balancing parallel reductors.
+inline constexpr std::size_t parallel_chunks_per_worker = 8;
+
+// Assumed cache line size (std::hardware_destructive_interference_size is not provided by all standard libraries).
+inline constexpr std::size_t cache_line_size = 64;
+
+// Value aligned to a cache line and padded to a multiple of its size, so that values updated by different threads
+// don't share one.
+template <class T>
+struct alignas(cache_line_size) padded_t
+{
+    T value;
+};
+
+}  // namespace detail
+
+template <class T>
+inline constexpr bool is_generator_v = detail::is_generator_impl<T>::value;
+
+template <class T>
+inline constexpr bool is_transducer_v = detail::is_transducer_impl<T>::value;
+
+template <class T>
+inline constexpr bool is_range_v = detail::is_range_impl<T>::value;
+
+template <class T>
+inline constexpr bool is_reductor_v = detail::is_reductor_impl<T>::value;
+
+template <
+    class Generator,
+    class Reductor,
+    class G = std::decay_t<Generator>,
+    std::enable_if_t<is_generator_v<G> && is_reductor_v<std::decay_t<Reductor>>, int> = 0>
+constexpr auto operator|=(Generator&& generator, Reductor&& reductor) -> typename std::decay_t<Reductor>::state_type
+{
+    auto run = detail::start(std::forward<Reductor>(reductor));
+    if constexpr (detail::is_sized_impl<G>::value)
+    {
+        run.reserve(std::size(generator));
+    }
+    std::forward<Generator>(generator)(run);
+    run.complete();
+    return std::move(run.state);
+}
+
+template <
+    class Transducer,
+    class State,
+    class Reducer,
+    class T = std::decay_t<Transducer>,
+    std::enable_if_t<is_transducer_v<T>, int> = 0>
+constexpr auto operator|=(Transducer&& transducer, const reductor_t<State, Reducer>& reductor)
+    -> reductor_t<State, std::invoke_result_t<Transducer, Reducer>>
+{
+    return { reductor.state, detail::invoke(std::forward<Transducer>(transducer), reductor.reducer) };
+}
+
+template <
+    class Transducer,
+    class State,
+    class Reducer,
+    class T = std::decay_t<Transducer>,
+    std::enable_if_t<is_transducer_v<T>, int> = 0>
+constexpr auto operator|=(Transducer&& transducer, reductor_t<State, Reducer>&& reductor)
+    -> reductor_t<State, std::invoke_result_t<Transducer, Reducer>>
+{
+    return { std::move(reductor.state), detail::invoke(std::forward<Transducer>(transducer), std::move(reductor.reducer)) };
+}
+
+template <
+    class Range,
+    class Reductor,
+    class R = std::decay_t<Range>,
+    std::enable_if_t<is_range_v<R> && is_reductor_v<std::decay_t<Reductor>>, int> = 0>
+constexpr auto operator|=(Range&& range, Reductor&& reductor) -> typename std::decay_t<Reductor>::state_type
+{
+    using state_type = typename std::decay_t<Reductor>::state_type;
+    using reducer_type = typename std::decay_t<Reductor>::reducer_type;
+    auto run = detail::start(std::forward<Reductor>(reductor));
+    if constexpr (detail::has_push_range_impl<reducer_type, state_type, R>::value)
+    {
+        run.reducer.push_range(run.state, range);
+    }
+    else
+    {
+        if constexpr (detail::is_sized_impl<R>::value)
+        {
+            run.reserve(std::size(range));
+        }
+        auto it = std::begin(range);
+        const auto end = std::end(range);
+        for (; it != end; ++it)
+        {
+            if (!run(*it))
+            {
+                break;
+            }
+        }
+    }
+    run.complete();
+    return std::move(run.state);
+}
+
+template <
+    class Transducer,
+    class State,
+    class Reducer,
+    class Merge,
+    class T = std::decay_t<Transducer>,
+    std::enable_if_t<is_transducer_v<T>, int> = 0>
+constexpr auto operator|=(Transducer&& transducer, parallel_reductor_t<State, Reducer, Merge> reductor)
+    -> parallel_reductor_t<State, std::invoke_result_t<Transducer, Reducer>, Merge>
+{
+    // Stateless transducers pass the run state of the next reducer through; any other one needs a single run, unless
+    // its run state may be kept per chunk.
+    using reducer_type = std::invoke_result_t<Transducer, Reducer>;
+    constexpr bool sequential = !std::is_same_v<run_state_t<reducer_type>, run_state_t<Reducer>>
+                                && !detail::run_state_per_chunk_impl<reducer_type>::value;
+    return { std::forward<Transducer>(transducer) |= std::move(reductor.m_reductor),
+             std::move(reductor.m_merge),
+             reductor.m_workers,
+             reductor.m_chunks_per_worker,
+             reductor.m_stable,
+             reductor.m_sequential || sequential };
+}
+
+template <
+    class Range,
+    class State,
+    class Reducer,
+    class Merge,
+    class R = std::decay_t<Range>,
+    std::enable_if_t<is_range_v<R>, int> = 0>
+auto operator|=(Range&& range, const parallel_reductor_t<State, Reducer, Merge>& reductor)
+    -> std::invoke_result_t<const Merge&, std::vector<State>>
+{
+    if (reductor.m_sequential)
+    {
+        std::vector<State> result;
+        result.push_back(std::forward<Range>(range) |= reductor.m_reductor);
+        return detail::invoke(reductor.m_merge, std::move(result));
+    }
+    const auto first = std::begin(range);
+    const auto size = static_cast<std::size_t>(std::distance(first, std::end(range)));
+    const auto workers = std::max<std::size_t>(1, std::min(reductor.m_workers, size));
+    const auto chunks = reductor.m_chunks_per_worker != 0
+                            ? std::max<std::size_t>(workers, std::min(size, workers * reductor.m_chunks_per_worker))
+                            : workers;
+    const bool state_per_chunk = reductor.m_stable || chunks == workers;
+    // The per-worker states are padded, so that workers updating adjacent states don't contend for a cache line.
+    std::vector<detail::padded_t<State>> states(state_per_chunk ? chunks : workers, { reductor.m_reductor.state });
+    // Worker `w` starts with chunk `w` and then takes the next untaken one.
+    std::atomic<std::size_t> next_chunk{ workers };
+    const auto take_chunk = [&] { return next_chunk.fetch_add(1, std::memory_order_relaxed); };
+    // Once a run stops early, no chunk after the first chunk it stopped in is started.
+    std::atomic<std::size_t> stop_chunk{ chunks };
+    const auto may_start = [&](std::size_t chunk) { return chunk < chunks && chunk <= stop_chunk.load(); };
+    const auto stop_at = [&](std::size_t chunk)
+    {
+        std::size_t current = stop_chunk.load();
+        while (chunk < current && !stop_chunk.compare_exchange_weak(current, chunk))
+        {
+        }
+    };
+    const auto run_chunk = [&](detail::run_t<State, Reducer>& run, std::size_t chunk) -> bool
+    {
+        auto it = std::next(first, static_cast<std::ptrdiff_t>(size * chunk / chunks));
+        const auto end = std::next(first, static_cast<std::ptrdiff_t>(size * (chunk + 1) / chunks));
+        run.reserve(static_cast<std::size_t>(std::distance(it, end)));
+        for (; it != end; ++it)
+        {
+            if (!run(*it))
+            {
+                stop_at(chunk);
+                return false;
+            }
+        }
+        return true;
+    };
+    detail::parallel_for(
+        workers,
+        [&](std::size_t worker)
+        {
+            if (state_per_chunk)
+            {
+                for (std::size_t chunk = worker; may_start(chunk); chunk = take_chunk())
+                {
+                    auto run = detail::run_t<State, Reducer>{ std::move(states[chunk].value), reductor.m_reductor.reducer };
+                    run_chunk(run, chunk);
+                    run.complete();
+                    states[chunk].value = std::move(run.state);
+                }
+            }
+            else
+            {
+                auto run = detail::run_t<State, Reducer>{ std::move(states[worker].value), reductor.m_reductor.reducer };
+                for (std::size_t chunk = worker; may_start(chunk) && run_chunk(run, chunk); chunk = take_chunk())
+                {
+                }
+                run.complete();
+                states[worker].value = std::move(run.state);
+            }
+        });
+    // In the input order, the states of the chunks after the one which stopped don't belong to the result.
+    const std::size_t count = reductor.m_stable ? std::min(states.size(), stop_chunk.load() + 1) : states.size();
+    std::vector<State> result;
+    result.reserve(count);
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        result.push_back(std::move(states[index].value));
+    }
+    return detail::invoke(reductor.m_merge, std::move(result));
+}
+
+namespace detail
+{
+
+struct to_reducer_fn
+{
+    template <class Reducer>
+    struct adapter_t
+    {
+        Reducer m_reducer;
+
+        template <class State, class... Args>
+        constexpr auto operator()(State& state, Args&&... args) const -> bool
+        {
+            state = detail::invoke(m_reducer, std::move(state), std::forward<Args>(args)...);
+            return true;
+        }
+    };
+
+    template <class Reducer>
+    constexpr auto operator()(Reducer&& reducer) const -> adapter_t<std::decay_t<Reducer>>
+    {
+        return { std::forward<Reducer>(reducer) };
+    }
+};
+
+template <class State, class Reducer>
+struct output_iterator_t
+{
+    using iterator_category = std::output_iterator_tag;
+    using value_type = void;
+    using difference_type = void;
+    using pointer = void;
+    using reference = void;
+    using state_type = State;
+    using reducer_type = Reducer;
+
+    reductor_t<State, Reducer> m_reductor;
+    run_state_t<Reducer> m_run_state = {};
+
+    constexpr auto operator*() -> output_iterator_t&
+    {
+        return *this;
+    }
+
+    constexpr auto operator++() -> output_iterator_t&
+    {
+        return *this;
+    }
+
+    constexpr auto operator++(int) -> output_iterator_t&
+    {
+        return *this;
+    }
+
+    template <class Arg>
+    constexpr auto operator=(Arg&& arg) -> output_iterator_t&
+    {
+        invoke_reducer(m_reductor.reducer, m_reductor.state, m_run_state, std::forward<Arg>(arg));
+        return *this;
+    }
+
+    constexpr auto get() const& -> const state_type&
+    {
+        return m_reductor.state;
+    }
+
+    constexpr auto get() & -> state_type&
+    {
+        return m_reductor.state;
+    }
+
+    constexpr auto get() && -> state_type&&
+    {
+        return std::move(m_reductor.state);
+    }
+};
+
+struct out_fn
+{
+    template <class State, class Reducer>
+    constexpr auto operator()(reductor_t<State, Reducer> reductor) const -> output_iterator_t<State, Reducer>
+    {
+        return { std::move(reductor) };
+    }
+};
+
+struct generator_slot_t
+{
+};
+
+template <class Source>
+constexpr auto zip_begin(Source& source)
+{
+    if constexpr (is_generator_impl<std::decay_t<Source>>::value)
+    {
+        return generator_slot_t{};
+    }
+    else
+    {
+        return std::begin(source);
+    }
+}
+
+template <class Source>
+constexpr auto zip_end(Source& source)
+{
+    if constexpr (is_generator_impl<std::decay_t<Source>>::value)
+    {
+        return generator_slot_t{};
+    }
+    else
+    {
+        return std::end(source);
+    }
+}
+
+template <class Iter>
+constexpr auto zip_at_end(const Iter& it, const Iter& end) -> bool
+{
+    if constexpr (std::is_same_v<Iter, generator_slot_t>)
+    {
+        return false;
+    }
+    else
+    {
+        return it == end;
+    }
+}
+
+template <class Iter>
+constexpr void zip_advance(Iter& it)
+{
+    if constexpr (!std::is_same_v<Iter, generator_slot_t>)
+    {
+        ++it;
+    }
+}
+
+template <class Iter, class Yielded>
+constexpr auto zip_current(Iter& it, Yielded& yielded)
+{
+    if constexpr (std::is_same_v<Iter, generator_slot_t>)
+    {
+        return std::move(yielded);
+    }
+    else
+    {
+        return std::tuple<decltype(*it)>(*it);
+    }
+}
+
+template <class... Sources>
+constexpr auto generator_index() -> std::size_t
+{
+    constexpr bool is_generator[] = { is_generator_impl<std::decay_t<Sources>>::value... };
+    std::size_t index = 0;
+    while (!is_generator[index])
+    {
+        ++index;
+    }
+    return index;
+}
+
+template <class Func, std::size_t... I, class... Sources>
+constexpr void zip_for_each_impl(Func& func, std::index_sequence<I...>, Sources&... sources)
+{
+    constexpr std::size_t generator_count = (std::size_t{ is_generator_impl<std::decay_t<Sources>>::value } + ...);
+    static_assert(generator_count <= 1, "at most one generator can be zipped with ranges");
+
+    if constexpr (generator_count == 0)
+    {
+        auto its = std::tuple{ std::begin(sources)... };
+        const auto ends = std::tuple{ std::end(sources)... };
+        for (; ((std::get<I>(its) != std::get<I>(ends)) && ...); (++std::get<I>(its), ...))
+        {
+            if (!func(*std::get<I>(its)...))
+            {
+                break;
+            }
+        }
+    }
+    else
+    {
+        auto its = std::tuple{ zip_begin(sources)... };
+        const auto ends = std::tuple{ zip_end(sources)... };
+        auto yield = [&](auto&&... args) -> bool
+        {
+            if ((zip_at_end(std::get<I>(its), std::get<I>(ends)) || ...))
+            {
+                return false;
+            }
+            auto yielded = std::forward_as_tuple(std::forward<decltype(args)>(args)...);
+            const bool result = std::apply(func, std::tuple_cat(zip_current(std::get<I>(its), yielded)...));
+            (zip_advance(std::get<I>(its)), ...);
+            return result;
+        };
+        std::get<generator_index<Sources...>()>(std::tie(sources...))(yield);
+    }
+}
+
+// Iterates over the sources in lockstep until the shortest one is exhausted, passing the current items of all sources
+// to `func` until it returns false. At most one source can be a generator, which then drives the iteration; the items
+// it yields are passed in its position.
+template <class Func, class... Sources>
+constexpr void zip_for_each(Func&& func, Sources&&... sources)
+{
+    zip_for_each_impl(func, std::index_sequence_for<Sources...>{}, sources...);
+}
+
+struct reduce_fn
+{
+    template <class Reductor, class Source_0, class... Sources>
+    constexpr auto operator()(Reductor&& reductor, Source_0&& source_0, Sources&&... sources) const
+        -> typename std::decay_t<Reductor>::state_type
+    {
+        auto run = start(std::forward<Reductor>(reductor));
+        if constexpr ((is_sized_impl<std::decay_t<Source_0>>::value && ... && is_sized_impl<std::decay_t<Sources>>::value))
+        {
+            run.reserve(std::min({ std::size(source_0), std::size(sources)... }));
+        }
+        zip_for_each(run, source_0, sources...);
+        run.complete();
+        return std::move(run.state);
+    }
+};
+
+constexpr inline auto reduce = reduce_fn{};
+
+template <class Range>
+using range_value_t = typename std::decay_t<Range>::value_type;
+
+template <class Source, class = void>
+struct source_value_types
+{
+    using type = std::tuple<range_value_t<Source>>;
+};
+
+template <class... Args>
+struct source_value_types<generator_t<Args...>>
+{
+    using type = std::tuple<Args...>;
+};
+
+template <class Tuple>
+struct generator_of;
+
+template <class... Args>
+struct generator_of<std::tuple<Args...>>
+{
+    using type = generator_t<Args...>;
+};
+
+template <class... Sources>
+using zip_generator_t = typename generator_of<
+    decltype(std::tuple_cat(std::declval<typename source_value_types<std::decay_t<Sources>>::type>()...))>::type;
+
+struct from_fn
+{
+    template <class Source_0, class... Sources>
+    constexpr auto operator()(Source_0&& source_0, Sources&&... sources) const -> zip_generator_t<Source_0, Sources...>
+    {
+        using generator_type = zip_generator_t<Source_0, Sources...>;
+        return generator_type([&](auto yield) { zip_for_each(yield, source_0, sources...); });
+    }
+};
+
+template <class Source, class = void>
+struct source_value
+{
+    using type = range_value_t<Source>;
+};
+
+template <class T>
+struct source_value<generator_t<T>>
+{
+    using type = T;
+};
+
+template <class Source>
+using source_value_t = typename source_value<std::decay_t<Source>>::type;
+
+// Concatenation of ranges and generators. Rvalue sources are stored by value, lvalue sources by reference. Each source
+// keeps its own type, so items are passed to the yield function without type erasure.
+template <class... Sources>
+class chain_t
+{
+public:
+    using value_type = std::common_type_t<source_value_t<Sources>...>;
+
+    template <class... Args>
+    constexpr explicit chain_t(Args&&... args) : m_sources{ std::forward<Args>(args)... }
+    {
+    }
+
+    template <class Yield>
+    constexpr void operator()(Yield&& yield) const
+    {
+        emit_all(yield, std::index_sequence_for<Sources...>{});
+    }
+
+    // Total number of items, available if all the sources are sized.
+    template <bool Sized = (is_sized_impl<std::decay_t<Sources>>::value && ...), std::enable_if_t<Sized, int> = 0>
+    constexpr auto size() const -> std::size_t
+    {
+        return std::apply([](const auto&... sources) { return (std::size_t{ 0 } + ... + std::size(sources)); }, m_sources);
+    }
+
+private:
+    template <class Yield, std::size_t... I>
+    constexpr auto emit_all(Yield& yield, std::index_sequence<I...>) const -> bool
+    {
+        return (emit(std::get<I>(m_sources), yield) && ...);
+    }
+
+    template <class Source, class Yield>
+    static constexpr auto emit(const Source& source, Yield& yield) -> bool
+    {
+        if constexpr (is_generator_impl<Source>::value)
+        {
+            bool proceed = true;
+            auto forward = [&](auto&&... args) -> bool
+            {
+                proceed = yield(std::forward<decltype(args)>(args)...);
+                return proceed;
+            };
+            source(forward);
+            return proceed;
+        }
+        else
+        {
+            for (auto&& item : source)
+            {
+                if (!yield(item))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+
+    std::tuple<Sources...> m_sources;
+};
+
+template <class... Sources>
+struct is_generator_impl<chain_t<Sources...>> : std::true_type
+{
+};
+
+struct chain_fn
+{
+    template <class Source_0, class... Sources>
+    constexpr auto operator()(Source_0&& source_0, Sources&&... sources) const -> chain_t<Source_0, Sources...>
+    {
+        return chain_t<Source_0, Sources...>{ std::forward<Source_0>(source_0), std::forward<Sources>(sources)... };
+    }
+};
+
+// Cursor over a source of a merge. Ranges are iterated in place.
+template <class T, class Source, class = void>
+struct merge_cursor_t
+{
+    decltype(std::begin(std::declval<Source&>())) it;
+    decltype(std::end(std::declval<Source&>())) end;
+
+    explicit merge_cursor_t(Source& source) : it{ std::begin(source) }, end{ std::end(source) }
+    {
+    }
+
+    void next(std::optional<T>& head)
+    {
+        if (it != end)
+        {
+            head.emplace(*it);
+            ++it;
+        }
+        else
+        {
+            head.reset();
+        }
+    }
+};
+
+// Generators cannot be suspended, so their items are collected up front.
+template <class T, class Source>
+struct merge_cursor_t<T, Source, std::enable_if_t<is_generator_impl<std::decay_t<Source>>::value>>
+{
+    std::vector<T> items;
+    std::size_t index = 0;
+
+    explicit merge_cursor_t(Source& source)
+    {
+        auto collect = [&](T item) -> bool
+        {
+            items.push_back(std::move(item));
+            return true;
+        };
+        source(collect);
+    }
+
+    void next(std::optional<T>& head)
+    {
+        if (index < items.size())
+        {
+            head.emplace(std::move(items[index++]));
+        }
+        else
+        {
+            head.reset();
+        }
+    }
+};
+
+// Tournament tree over the heads of k sorted sources: `m_nodes[0]` is the index of the source with the smallest head,
+// `m_nodes[1..k)` hold the losers of the matches, the leaves are implicit at positions k..2k. Replacing the winner
+// replays the matches on its path only, i.e. log2(k) comparisons. Ties are resolved by source index.
+template <class T, class Compare>
+class loser_tree
+{
+public:
+    loser_tree(std::vector<std::optional<T>> heads, Compare compare)
+        : m_heads(std::move(heads))
+        , m_compare(std::move(compare))
+        , m_nodes(std::max<std::size_t>(m_heads.size(), 1))
+    {
+        const std::size_t k = m_heads.size();
+        std::vector<std::size_t> winners(k);
+        const auto winner_of = [&](std::size_t node) { return node >= k ? node - k : winners[node]; };
+        for (std::size_t node = k - 1; node > 0; --node)
+        {
+            const std::size_t lhs = winner_of(2 * node);
+            const std::size_t rhs = winner_of(2 * node + 1);
+            const bool lhs_wins = beats(lhs, rhs);
+            winners[node] = lhs_wins ? lhs : rhs;
+            m_nodes[node] = lhs_wins ? rhs : lhs;
+        }
+        m_nodes[0] = k > 1 ? winners[1] : 0;
+    }
+
+    auto winner() const -> std::size_t
+    {
+        return m_nodes[0];
+    }
+
+    auto empty() const -> bool
+    {
+        return m_heads.empty() || !m_heads[m_nodes[0]];
+    }
+
+    auto head() -> T&
+    {
+        return *m_heads[m_nodes[0]];
+    }
+
+    auto head_of(std::size_t source) -> std::optional<T>&
+    {
+        return m_heads[source];
+    }
+
+    // Restores the invariant after the head of the winning source was replaced.
+    void replay()
+    {
+        std::size_t winner = m_nodes[0];
+        for (std::size_t node = (winner + m_heads.size()) / 2; node > 0; node /= 2)
+        {
+            if (beats(m_nodes[node], winner))
+            {
+                std::swap(m_nodes[node], winner);
+            }
+        }
+        m_nodes[0] = winner;
+    }
+
+private:
+    auto beats(std::size_t lhs, std::size_t rhs) const -> bool
+    {
+        if (!m_heads[lhs] || !m_heads[rhs])
+        {
+            return static_cast<bool>(m_heads[lhs]) || (!m_heads[rhs] && lhs < rhs);
+        }
+        if (detail::invoke(m_compare, *m_heads[lhs], *m_heads[rhs]))
+        {
+            return true;
+        }
+        return !detail::invoke(m_compare, *m_heads[rhs], *m_heads[lhs]) && lhs < rhs;
+    }
+
+    std::vector<std::optional<T>> m_heads;
+    Compare m_compare;
+    std::vector<std::size_t> m_nodes;
+};
+
+template <class Tuple, class Func, std::size_t... I>
+void visit_at(Tuple& tuple, std::size_t index, Func&& func, std::index_sequence<I...>)
+{
+    ((index == I ? (void)func(std::get<I>(tuple)) : (void)0), ...);
+}
+
+struct merge_fn
+{
+    template <class Compare, class Source_0, class... Sources>
+    auto operator()(Compare&& compare, Source_0&& source_0, Sources&&... sources) const
+        -> generator_t<std::common_type_t<source_value_t<Source_0>, source_value_t<Sources>...>>
+    {
+        using value_type = std::common_type_t<source_value_t<Source_0>, source_value_t<Sources>...>;
+        using generator_type = generator_t<value_type>;
+        using cursors_type = std::tuple<merge_cursor_t<value_type, std::remove_reference_t<Source_0>>,
+                                        merge_cursor_t<value_type, std::remove_reference_t<Sources>>...>;
+        // As in chain, rvalue sources are stored by value, lvalue sources by reference.
+        return generator_type(
+            [stored = std::tuple<Source_0, Sources...>{ std::forward<Source_0>(source_0),
+                                                        std::forward<Sources>(sources)... },
+             compare = std::forward<Compare>(compare)](auto yield) mutable
+            {
+                cursors_type cursors = std::apply([](auto&... source) { return cursors_type{ source... }; }, stored);
+                constexpr auto indices = std::index_sequence_for<Source_0, Sources...>{};
+
+                std::vector<std::optional<value_type>> heads(1 + sizeof...(Sources));
+                for (std::size_t i = 0; i < heads.size(); ++i)
+                {
+                    visit_at(cursors, i, [&](auto& cursor) { cursor.next(heads[i]); }, indices);
+                }
+
+                loser_tree<value_type, std::decay_t<Compare>> tree{ std::move(heads), compare };
+                while (!tree.empty())
+                {
+                    const std::size_t winner = tree.winner();
+                    if (!yield(std::move(tree.head())))
+                    {
+                        return;
+                    }
+                    visit_at(cursors, winner, [&](auto& cursor) { cursor.next(tree.head_of(winner)); }, indices);
+                    tree.replay();
+                }
+            });
+    }
+};
+
+// Default number of items between two polls of a cancellation token or a clock.
+inline constexpr std::size_t cancellation_period = 16;
+
+// Polls the token on every period-th call only, so that a hot loop doesn't pay for an atomic load and a clock read per
+// item. The first call always polls.
+inline auto stop_requested(const cancellation_token& token, std::size_t period, std::size_t& countdown) -> bool
+{
+    if (countdown != 0)
+    {
+        --countdown;
+        return false;
+    }
+    countdown = std::max<std::size_t>(period, 1) - 1;
+    return token.stop_requested();
+}
+
+// Source which stops yielding once the token is stop-requested.
+template <class Source>
+class cancellable_t
+{
+public:
+    using value_type = source_value_t<Source>;
+
+    template <class Arg>
+    cancellable_t(Arg&& source, cancellation_token token, std::size_t period)
+        : m_source{ std::forward<Arg>(source) }
+        , m_token{ std::move(token) }
+        , m_period{ period }
+    {
+    }
+
+    template <class Yield>
+    void operator()(Yield&& yield) const
+    {
+        std::size_t countdown = 0;
+        m_source(
+            [&](auto&&... args) -> bool
+            {
+                return !stop_requested(m_token, m_period, countdown) && yield(std::forward<decltype(args)>(args)...);
+            });
+    }
+
+private:
+    chain_t<Source> m_source;
+    cancellation_token m_token;
+    std::size_t m_period;
+};
+
+template <class Source>
+struct is_generator_impl<cancellable_t<Source>> : std::true_type
+{
+};
+
+struct cancellable_fn
+{
+    template <class Source>
+    auto operator()(Source&& source, cancellation_token token, std::size_t period = cancellation_period) const
+        -> cancellable_t<Source>
+    {
+        return { std::forward<Source>(source), std::move(token), period };
+    }
+};
+
+// Generator of values in [lower, upper).
+template <class T>
+struct range_t
+{
+    using value_type = T;
+
+    T lower;
+    T upper;
+
+    template <class Yield>
+    constexpr void operator()(Yield&& yield) const
+    {
+        for (T value = lower; value < upper; ++value)
+        {
+            if (!yield(value))
+            {
+                return;
+            }
+        }
+    }
+
+    constexpr auto size() const -> std::size_t
+    {
+        return lower < upper ? static_cast<std::size_t>(upper - lower) : 0;
+    }
+};
+
+// Unbounded generator of values starting with lower.
+template <class T>
+struct iota_t
+{
+    using value_type = T;
+
+    T lower;
+
+    template <class Yield>
+    constexpr void operator()(Yield&& yield) const
+    {
+        for (T value = lower;; ++value)
+        {
+            if (!yield(value))
+            {
+                return;
+            }
+        }
+    }
+};
+
+template <class T>
+struct is_generator_impl<range_t<T>> : std::true_type
+{
+};
+
+template <class T>
+struct is_generator_impl<iota_t<T>> : std::true_type
+{
+};
+
+struct range_fn
+{
+    template <class T>
+    constexpr auto operator()(T lower, T upper) const -> range_t<T>
+    {
+        return { lower, upper };
+    }
+
+    template <class T>
+    constexpr auto operator()(T upper) const -> range_t<T>
+    {
+        return { T{}, upper };
+    }
+};
+
+struct iota_fn
+{
+    template <class T = std::ptrdiff_t>
+    constexpr auto operator()(T lower = {}) const -> iota_t<T>
+    {
+        return { lower };
+    }
+
+    template <class T>
+    auto operator()(T lower, cancellation_token token, std::size_t period = cancellation_period) const
+        -> cancellable_t<iota_t<T>>
+    {
+        return { iota_t<T>{ lower }, std::move(token), period };
+    }
+};
+
+struct read_lines_fn
+{
+    static auto read_line(std::istream& in, std::string& line) -> std::istream&
+    {
+        line.clear();
+        char ch;
+
+        while (true)
+        {
+            if (!in.get(ch))
+            {
+                if (!line.empty())
+                {
+                    in.clear(in.rdstate() & ~std::ios::failbit);
+                    in.setstate(std::ios::eofbit);
+                    return in;
+                }
+
+                in.setstate(std::ios::failbit);
+                return in;
+            }
+
+            if (ch == '\n')
+            {
+                return in;
+            }
+
+            if (ch == '\r')
+            {
+                if (in.peek() == '\n')
+                {
+                    in.get();
+                }
+
+                return in;
+            }
+
+            line.push_back(ch);
+        }
+    }
+
+    auto operator()(std::istream& is) const -> generator_t<std::string>
+    {
+        using generator_type = generator_t<std::string>;
+        return generator_type(
+            [&](auto yield)
+            {
+                std::string line;
+                while (read_line(is, line))
+                {
+                    if (!yield(line))
+                    {
+                        return;
+                    }
+                }
+            });
+    }
+
+    // Stops at the first line read after the token was stop-requested; a read blocked on the stream is not interrupted.
+    auto operator()(std::istream& is, cancellation_token token, std::size_t period = cancellation_period) const
+        -> generator_t<std::string>
+    {
+        using generator_type = generator_t<std::string>;
+        return generator_type(
+            [&is, token = std::move(token), period](auto yield)
+            {
+                std::string line;
+                std::size_t countdown = 0;
+                while (!stop_requested(token, period, countdown) && read_line(is, line))
+                {
+                    if (!yield(line))
+                    {
+                        return;
+                    }
+                }
+            });
+    }
+};
+
+template <template <class...> class R, class Arg>
+struct transducer_t
+{
+    Arg m_arg;
+
+    template <class Reducer>
+    constexpr auto operator()(Reducer&& next_reducer) const& -> R<std::decay_t<Reducer>, Arg>
+    {
+        return {
+            std::forward<Reducer>(next_reducer),
+            m_arg,
+        };
+    }
+
+    template <class Reducer>
+    constexpr auto operator()(Reducer&& next_reducer) && -> R<std::decay_t<Reducer>, Arg>
+    {
+        return {
+            std::forward<Reducer>(next_reducer),
+            std::move(m_arg),
+        };
+    }
+};
+
+template <template <class...> class R>
+struct transducer_t<R, void>
+{
+    template <class Reducer>
+    constexpr auto operator()(Reducer&& next_reducer) const& -> R<std::decay_t<Reducer>>
+    {
+        return { std::forward<Reducer>(next_reducer) };
+    }
+
+    template <class Reducer>
+    constexpr auto operator()(Reducer&& next_reducer) && -> R<std::decay_t<Reducer>>
+    {
+        return { std::forward<Reducer>(next_reducer) };
+    }
+};
+
+struct filter_fn
+{
+    template <class Reducer, class Pred>
+    struct reducer_t
+    {
+        Reducer m_next_reducer;
+        Pred m_pred;
+
+        using run_state_type = run_state_t<Reducer>;
+
+        template <class State, class... Args>
+        constexpr auto operator()(State& state, run_state_type& run_state, Args&&... args) const -> bool
+        {
+            if (detail::invoke(m_pred, args...))
+            {
+                return invoke_reducer(m_next_reducer, state, run_state, std::forward<Args>(args)...);
+            }
+            return true;
+        }
+
+        template <class State>
+        constexpr void complete(State& state, run_state_type& run_state) const
+        {
+            complete_reducer(m_next_reducer, state, run_state);
+        }
+    };
+
+    template <class Pred>
+    constexpr auto operator()(Pred&& pred) const -> transducer_t<reducer_t, std::decay_t<Pred>>
+    {
+        return { std::forward<Pred>(pred) };
+    }
+};
+
+struct filter_indexed_fn
+{
+    template <class Reducer, class Pred>
+    struct reducer_t
+    {
+        Reducer m_next_reducer;
+        Pred m_pred;
+
+        struct run_state_type
+        {
+            std::ptrdiff_t index = 0;
+            run_state_t<Reducer> next = {};
+        };
+
+        template <class State, class... Args>
+        constexpr auto operator()(State& state, run_state_type& run_state, Args&&... args) const -> bool
+        {
+            if (detail::invoke(m_pred, run_state.index++, std::forward<Args>(args)...))
+            {
+                return invoke_reducer(m_next_reducer, state, run_state.next, std::forward<Args>(args)...);
+            }
+            return true;
+        }
+
+        template <class State>
+        constexpr void complete(State& state, run_state_type& run_state) const
+        {
+            complete_reducer(m_next_reducer, state, run_state.next);
+        }
+    };
+
+    template <class Pred>
+    constexpr auto operator()(Pred&& pred) const -> transducer_t<reducer_t, std::decay_t<Pred>>
+    {
+        return { std::forward<Pred>(pred) };
+    }
+};
+
+struct transform_fn
+{
+    template <class Reducer, class Func>
+    struct reducer_t
+    {
+        Reducer m_next_reducer;
+        Func m_func;
+
+        using run_state_type = run_state_t<Reducer>;
+
+        template <class State, class... Args>
+        constexpr auto operator()(State& state, run_state_type& run_state, Args&&... args) const -> bool
+        {
+            return invoke_reducer(m_next_reducer, state, run_state, detail::invoke(m_func, std::forward<Args>(args)...));
+        }
+
+        template <class State>
+        constexpr void complete(State& state, run_state_type& run_state) const
+        {
+            complete_reducer(m_next_reducer, state, run_state);
+        }
+
+        template <class State>
+        constexpr void reserve(State& state, run_state_type& run_state, std::size_t size) const
+        {
+            reserve_reducer(m_next_reducer, state, run_state, size);
+        }
+    };
+
+    template <class Func>
+    constexpr auto operator()(Func&& func) const -> transducer_t<reducer_t, std::decay_t<Func>>
+    {
+        return { std::forward<Func>(func) };
+    }
+};
+
+struct transform_indexed_fn
+{
+    template <class Reducer, class Func>
+    struct reducer_t
+    {
+        Reducer m_next_reducer;
+        Func m_func;
+
+        struct run_state_type
+        {
+            std::ptrdiff_t index = 0;
+            run_state_t<Reducer> next = {};
+        };
+
+        template <class State, class... Args>
+        constexpr auto operator()(State& state, run_state_type& run_state, Args&&... args) const -> bool
+        {
+            return invoke_reducer(
+                m_next_reducer,
+                state,
+                run_state.next,
+                detail::invoke(m_func, run_state.index++, std::forward<Args>(args)...));
+        }
+
+        template <class State>
+        constexpr void complete(State& state, run_state_type& run_state) const
+        {
+            complete_reducer(m_next_reducer, state, run_state.next);
+        }
+
+        template <class State>
+        constexpr void reserve(State& state, run_state_type& run_state, std::size_t size) const
+        {
+            reserve_reducer(m_next_reducer, state, run_state.next, size);
+        }
+    };
+
+    template <class Func>
+    constexpr auto operator()(Func&& func) const -> transducer_t<reducer_t, std::decay_t<Func>>
+    {
+        return { std::forward<Func>(func) };
+    }
+};
+
+struct inspect_fn
+{
+    template <class Reducer, class Func>
+    struct reducer_t
+    {
+        Reducer m_next_reducer;
+        Func m_func;
+
+        using run_state_type = run_state_t<Reducer>;
+
+        template <class State, class... Args>
+        constexpr auto operator()(State& state, run_state_type& run_state, Args&&... args) const -> bool
+        {
+            detail::invoke(m_func, args...);
+            return invoke_reducer(m_next_reducer, state, run_state, std::forward<Args>(args)...);
+        }
+
+        template <class State>
+        constexpr void complete(State& state, run_state_type& run_state) const
+        {
+            complete_reducer(m_next_reducer, state, run_state);
+        }
+
+        template <class State>
+        constexpr void reserve(State& state, run_state_type& run_state, std::size_t size) const
+        {
+            reserve_reducer(m_next_reducer, state, run_state, size);
+        }
+    };
+
+    template <class Func>
+    constexpr auto operator()(Func&& func) const -> transducer_t<reducer_t, std::decay_t<Func>>
+    {
+        return { std::forward<Func>(func) };
+    }
+};
+
+struct inspect_indexed_fn
+{
+    template <class Reducer, class Func>
+    struct reducer_t
+    {
+        Reducer m_next_reducer;
+        Func m_func;
+
+        struct run_state_type
+        {
+            std::ptrdiff_t index = 0;
+            run_state_t<Reducer> next = {};
+        };
+
+        template <class State, class... Args>
+        constexpr auto operator()(State& state, run_state_type& run_state, Args&&... args) const -> bool
+        {
+            detail::invoke(m_func, run_state.index++, args...);
+            return invoke_reducer(m_next_reducer, state, run_state.next, std::forward<Args>(args)...);
+        }
+
+        template <class State>
+        constexpr void complete(State& state, run_state_type& run_state) const
+        {
+            complete_reducer(m_next_reducer, state, run_state.next);
+        }
+
+        template <class State>
+        constexpr void reserve(State& state, run_state_type& run_state, std::size_t size) const
+        {
+            reserve_reducer(m_next_reducer, state, run_state.next, size);
+        }
+    };
+
+    template <class Func>
+    constexpr auto operator()(Func&& func) const -> transducer_t<reducer_t, std::decay_t<Func>>
+    {
+        return { std::forward<Func>(func) };
+    }
+};
+
+struct transform_maybe_fn
+{
+    template <class Reducer, class Func>
+    struct reducer_t
+    {
+        Reducer m_next_reducer;
+        Func m_func;
+
+        using run_state_type = run_state_t<Reducer>;
+
+        template <class State, class... Args>
+        constexpr auto operator()(State& state, run_state_type& run_state, Args&&... args) const -> bool
+        {
+            if (auto res = detail::invoke(m_func, std::forward<Args>(args)...))
+            {
+                return invoke_reducer(m_next_reducer, state, run_state, *std::move(res));
+            }
+            return true;
+        }
+
+        template <class State>
+        constexpr void complete(State& state, run_state_type& run_state) const
+        {
+            complete_reducer(m_next_reducer, state, run_state);
+        }
+    };
+
+    template <class Func>
+    constexpr auto operator()(Func&& func) const -> transducer_t<reducer_t, std::decay_t<Func>>
+    {
+        return { std::forward<Func>(func) };
+    }
+};
+
+struct transform_maybe_indexed_fn
+{
+    template <class Reducer, class Func>
+    struct reducer_t
+    {
+        Reducer m_next_reducer;
+        Func m_func;
+
+        struct run_state_type
+        {
+            std::ptrdiff_t index = 0;
+            run_state_t<Reducer> next = {};
+        };
+
+        template <class State, class... Args>
+        constexpr auto operator()(State& state, run_state_type& run_state, Args&&... args) const -> bool
+        {
+            if (auto res = detail::invoke(m_func, run_state.index++, std::forward<Args>(args)...))
+            {
+                return invoke_reducer(m_next_reducer, state, run_state.next, *std::move(res));
+            }
+            return true;
+        }
+
+        template <class State>
+        constexpr void complete(State& state, run_state_type& run_state) const
+        {
+            complete_reducer(m_next_reducer, state, run_state.next);
+        }
+    };
+
+    template <class Func>
+    constexpr auto operator()(Func&& func) const -> transducer_t<reducer_t, std::decay_t<Func>>
+    {
+        return { std::forward<Func>(func) };
+    }
+};
+
+struct unpack_fn
+{
+    template <class Reducer>
+    struct reducer_t
+    {
+        Reducer m_next_reducer;
+
+        using run_state_type = run_state_t<Reducer>;
+
+        template <class State, class Arg>
+        constexpr auto operator()(State& state, run_state_type& run_state, Arg&& arg) const -> bool
+        {
+            return std::apply(
+                [&](auto&&... args)
+                { return invoke_reducer(m_next_reducer, state, run_state, std::forward<decltype(args)>(args)...); },
+                std::forward<Arg>(arg));
+        }
+
+        template <class State>
+        constexpr void complete(State& state, run_state_type& run_state) const
+        {
+            complete_reducer(m_next_reducer, state, run_state);
+        }
+
+        template <class State>
+        constexpr void reserve(State& state, run_state_type& run_state, std::size_t size) const
+        {
+            reserve_reducer(m_next_reducer, state, run_state, size);
+        }
+    };
+
+    constexpr auto operator()() const -> transducer_t<reducer_t, void>
+    {
+        return {};
+    }
+};
+
+struct project_fn
+{
+    template <class Reducer, class Funcs>
+    struct reducer_t
+    {
+        Reducer m_next_reducer;
+        Funcs m_funcs;
+
+        using run_state_type = run_state_t<Reducer>;
+
+        template <class State, class... Args>
+        constexpr auto operator()(State& state, run_state_type& run_state, Args&&... args) const -> bool
+        {
+            return std::apply(
+                [&](auto&&... funcs)
+                {
+                    return invoke_reducer(
+                        m_next_reducer, state, run_state, detail::invoke(funcs, std::forward<Args>(args)...)...);
+                },
+                m_funcs);
+        }
+
+        template <class State>
+        constexpr void complete(State& state, run_state_type& run_state) const
+        {
+            complete_reducer(m_next_reducer, state, run_state);
+        }
+
+        template <class State>
+        constexpr void reserve(State& state, run_state_type& run_state, std::size_t size) const
+        {
+            reserve_reducer(m_next_reducer, state, run_state, size);
+        }
+    };
+
+    template <class... Funcs>
+    constexpr auto operator()(Funcs&&... funcs) const -> transducer_t<reducer_t, std::tuple<std::decay_t<Funcs>...>>
+    {
+        return { std::make_tuple(std::forward<Funcs>(funcs)...) };
+    }
+};
+
+struct take_while_fn
+{
+    template <class Reducer, class Pred>
+    struct reducer_t
+    {
+        Reducer m_next_reducer;
+        Pred m_pred;
+
+        struct run_state_type
+        {
+            bool done = false;
+            run_state_t<Reducer> next = {};
+        };
+
+        template <class State, class... Args>
+        constexpr auto operator()(State& state, run_state_type& run_state, Args&&... args) const -> bool
+        {
+            run_state.done |= !detail::invoke(m_pred, args...);
+            if (!run_state.done)
+            {
+                return invoke_reducer(m_next_reducer, state, run_state.next, std::forward<Args>(args)...);
+            }
+            return false;
+        }
+
+        template <class State>
+        constexpr void complete(State& state, run_state_type& run_state) const
+        {
+            complete_reducer(m_next_reducer, state, run_state.next);
+        }
+    };
+
+    template <class Pred>
+    constexpr auto operator()(Pred&& pred) const -> transducer_t<reducer_t, std::decay_t<Pred>>
+    {
+        return { std::forward<Pred>(pred) };
+    }
+};
+
+struct take_while_indexed_fn
+{
+    template <class Reducer, class Pred>
+    struct reducer_t
+    {
+        Reducer m_next_reducer;
+        Pred m_pred;
+
+        struct run_state_type
+        {
+            bool done = false;
+            std::ptrdiff_t index = 0;
+            run_state_t<Reducer> next = {};
+        };
+
+        template <class State, class... Args>
+        constexpr auto operator()(State& state, run_state_type& run_state, Args&&... args) const -> bool
+        {
+            run_state.done |= !detail::invoke(m_pred, run_state.index++, args...);
+            if (!run_state.done)
+            {
+                return invoke_reducer(m_next_reducer, state, run_state.next, std::forward<Args>(args)...);
+            }
+            return false;
+        }
+
+        template <class State>
+        constexpr void complete(State& state, run_state_type& run_state) const
+        {
+            complete_reducer(m_next_reducer, state, run_state.next);
+        }
+    };
+
+    template <class Pred>
+    constexpr auto operator()(Pred&& pred) const -> transducer_t<reducer_t, std::decay_t<Pred>>
+    {
+        return { std::forward<Pred>(pred) };
+    }
+};
+
+struct drop_while_fn
+{
+    template <class Reducer, class Pred>
+    struct reducer_t
+    {
+        Reducer m_next_reducer;
+        Pred m_pred;
+
+        struct run_state_type
+        {
+            bool done = false;
+            run_state_t<Reducer> next = {};
+        };
+
+        template <class State, class... Args>
+        constexpr auto operator()(State& state, run_state_type& run_state, Args&&... args) const -> bool
+        {
+            run_state.done |= !detail::invoke(m_pred, args...);
+            if (run_state.done)
+            {
+                return invoke_reducer(m_next_reducer, state, run_state.next, std::forward<Args>(args)...);
+            }
+            return true;
+        }
+
+        template <class State>
+        constexpr void complete(State& state, run_state_type& run_state) const
+        {
+            complete_reducer(m_next_reducer, state, run_state.next);
+        }
+    };
+
+    template <class Pred>
+    constexpr auto operator()(Pred&& pred) const -> transducer_t<reducer_t, std::decay_t<Pred>>
+    {
+        return { std::forward<Pred>(pred) };
+    }
+};
+
+struct drop_while_indexed_fn
+{
+    template <class Reducer, class Pred>
+    struct reducer_t
+    {
+        Reducer m_next_reducer;
+        Pred m_pred;
+
+        struct run_state_type
+        {
+            bool done = false;
+            std::ptrdiff_t index = 0;
+            run_state_t<Reducer> next = {};
+        };
+
+        template <class State, class... Args>
+        constexpr auto operator()(State& state, run_state_type& run_state, Args&&... args) const -> bool
+        {
+            run_state.done |= !detail::invoke(m_pred, run_state.index++, args...);
+            if (run_state.done)
+            {
+                return invoke_reducer(m_next_reducer, state, run_state.next, std::forward<Args>(args)...);
+            }
+            return true;
+        }
+
+        template <class State>
+        constexpr void complete(State& state, run_state_type& run_state) const
+        {
+            complete_reducer(m_next_reducer, state, run_state.next);
+        }
+    };
+
+    template <class Pred>
+    constexpr auto operator()(Pred&& pred) const -> transducer_t<reducer_t, std::decay_t<Pred>>
+    {
+        return { std::forward<Pred>(pred) };
+    }
+};
+
+struct take_fn
+{
+    template <class Reducer, class>
+    struct reducer_t
+    {
+        Reducer m_next_reducer;
+        std::ptrdiff_t m_count;
+
+        struct run_state_type
+        {
+            std::ptrdiff_t index = 0;
+            run_state_t<Reducer> next = {};
+        };
+
+        template <class State, class... Args>
+        constexpr auto operator()(State& state, run_state_type& run_state, Args&&... args) const -> bool
+        {
+            if (run_state.index++ < m_count)
+            {
+                return invoke_reducer(m_next_reducer, state, run_state.next, std::forward<Args>(args)...);
+            }
+            return false;
+        }
+
+        template <class State>
+        constexpr void complete(State& state, run_state_type& run_state) const
+        {
+            complete_reducer(m_next_reducer, state, run_state.next);
+        }
+    };
+
+    constexpr auto operator()(std::ptrdiff_t count) const -> transducer_t<reducer_t, std::ptrdiff_t>
+    {
+        return { count };
+    }
+};
+
+struct cancel_on_fn
+{
+    struct params_t
+    {
+        cancellation_token token;
+        std::size_t period;
+    };
+
+    template <class Reducer, class>
+    struct reducer_t
+    {
+        Reducer m_next_reducer;
+        params_t m_params;
+
+        // The countdown only paces the polling of the token, so every chunk of a parallel run may have its own.
+        static constexpr bool run_state_per_chunk = true;
+
+        struct run_state_type
+        {
+            std::size_t countdown = 0;
+            run_state_t<Reducer> next = {};
+        };
+
+        template <class State, class... Args>
+        auto operator()(State& state, run_state_type& run_state, Args&&... args) const -> bool
+        {
+            return !stop_requested(m_params.token, m_params.period, run_state.countdown)
+                   && invoke_reducer(m_next_reducer, state, run_state.next, std::forward<Args>(args)...);
+        }
+
+        template <class State>
+        void complete(State& state, run_state_type& run_state) const
+        {
+            complete_reducer(m_next_reducer, state, run_state.next);
+        }
+    };
+
+    auto operator()(cancellation_token token, std::size_t period = cancellation_period) const
+        -> transducer_t<reducer_t, params_t>
+    {
+        return { params_t{ std::move(token), period } };
+    }
+};
+
+struct take_for_fn
+{
+    using clock = std::chrono::steady_clock;
+
+    struct params_t
+    {
+        clock::duration budget;
+        std::size_t period;
+    };
+
+    template <class Reducer, class>
+    struct reducer_t
+    {
+        Reducer m_next_reducer;
+        params_t m_params;
+
+        // The budget is measured from the start of the run.
+        struct run_state_type
+        {
+            clock::time_point start = clock::now();
+            std::size_t countdown = 0;
+            run_state_t<Reducer> next = {};
+        };
+
+        template <class State, class... Args>
+        auto operator()(State& state, run_state_type& run_state, Args&&... args) const -> bool
+        {
+            if (run_state.countdown != 0)
+            {
+                --run_state.countdown;
+            }
+            else
+            {
+                run_state.countdown = std::max<std::size_t>(m_params.period, 1) - 1;
+                if (clock::now() - run_state.start >= m_params.budget)
+                {
+                    return false;
+                }
+            }
+            return invoke_reducer(m_next_reducer, state, run_state.next, std::forward<Args>(args)...);
+        }
+
+        template <class State>
+        void complete(State& state, run_state_type& run_state) const
+        {
+            complete_reducer(m_next_reducer, state, run_state.next);
+        }
+    };
+
+    auto operator()(clock::duration budget, std::size_t period = cancellation_period) const
+        -> transducer_t<reducer_t, params_t>
+    {
+        return { params_t{ budget, period } };
+    }
+};
+
+struct drop_fn
+{
+    template <class Reducer, class>
+    struct reducer_t
+    {
+        Reducer m_next_reducer;
+        std::ptrdiff_t m_count;
+
+        struct run_state_type
+        {
+            std::ptrdiff_t index = 0;
+            run_state_t<Reducer> next = {};
+        };
+
+        template <class State, class... Args>
+        constexpr auto operator()(State& state, run_state_type& run_state, Args&&... args) const -> bool
+        {
+            if (run_state.index >= m_count)
+            {
+                return invoke_reducer(m_next_reducer, state, run_state.next, std::forward<Args>(args)...);
+            }
+            ++run_state.index;
+            return true;
+        }
+
+        template <class State>
+        constexpr void complete(State& state, run_state_type& run_state) const
+        {
+            complete_reducer(m_next_reducer, state, run_state.next);
+        }
+    };
+
+    constexpr auto operator()(std::ptrdiff_t count) const -> transducer_t<reducer_t, std::ptrdiff_t>
+    {
+        return { count };
+    }
+};
+
+struct stride_fn
+{
+    template <class Reducer, class>
+    struct reducer_t
+    {
+        Reducer m_next_reducer;
+        std::ptrdiff_t m_count;
+
+        struct run_state_type
+        {
+            std::ptrdiff_t index = 0;
+            run_state_t<Reducer> next = {};
+        };
+
+        template <class State, class... Args>
+        constexpr auto operator()(State& state, run_state_type& run_state, Args&&... args) const -> bool
+        {
+            if (run_state.index++ % m_count == 0)
+            {
+                return invoke_reducer(m_next_reducer, state, run_state.next, std::forward<Args>(args)...);
+            }
+            return true;
+        }
+
+        template <class State>
+        constexpr void complete(State& state, run_state_type& run_state) const
+        {
+            complete_reducer(m_next_reducer, state, run_state.next);
+        }
+    };
+
+    constexpr auto operator()(std::ptrdiff_t count) const -> transducer_t<reducer_t, std::ptrdiff_t>
+    {
+        return { count };
+    }
+};
+
+struct join_fn
+{
+    template <class Reducer>
+    struct reducer_t
+    {
+        Reducer m_next_reducer;
+
+        using run_state_type = run_state_t<Reducer>;
+
+        template <class State, class Arg>
+        constexpr auto operator()(State& state, run_state_type& run_state, Arg&& arg) const -> bool
+        {
+            for (auto&& item : arg)
+            {
+                if (!invoke_reducer(m_next_reducer, state, run_state, std::forward<decltype(item)>(item)))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        template <class State>
+        constexpr void complete(State& state, run_state_type& run_state) const
+        {
+            complete_reducer(m_next_reducer, state, run_state);
+        }
+    };
+
+    constexpr auto operator()() const -> transducer_t<reducer_t, void>
+    {
+        return {};
+    }
+};
+
+// Splits blocks of characters (e.g. from read_blocks) into lines, passed to the next reducer as std::string_view. Lines
+// are separated by LF or CRLF; a line spanning blocks is assembled in a buffer.
+struct split_lines_fn
+{
+    template <class Reducer>
+    struct reducer_t
+    {
+        Reducer m_next_reducer;
+
+        struct run_state_type
+        {
+            std::string partial = {};
+            bool done = false;
+            run_state_t<Reducer> next = {};
+        };
+
+        template <class State, class Block>
+        auto operator()(State& state, run_state_type& run_state, const Block& block) const -> bool
+        {
+            const char* it = std::data(block);
+            const char* const end = it + std::size(block);
+            while (const void* found = std::memchr(it, '\n', static_cast<std::size_t>(end - it)))
+            {
+                const char* const eol = static_cast<const char*>(found);
+                std::string_view line{ it, static_cast<std::size_t>(eol - it) };
+                if (!run_state.partial.empty())
+                {
+                    run_state.partial.append(line);
+                    line = run_state.partial;
+                }
+                it = eol + 1;
+                if (!emit(state, run_state, line))
+                {
+                    return false;
+                }
+            }
+            run_state.partial.append(it, end);
+            return true;
+        }
+
+        template <class State>
+        void complete(State& state, run_state_type& run_state) const
+        {
+            if (!run_state.done && !run_state.partial.empty())
+            {
+                emit(state, run_state, run_state.partial);
+            }
+            complete_reducer(m_next_reducer, state, run_state.next);
+        }
+
+        template <class State>
+        auto emit(State& state, run_state_type& run_state, std::string_view line) const -> bool
+        {
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.remove_suffix(1);
+            }
+            run_state.done = !invoke_reducer(m_next_reducer, state, run_state.next, line);
+            run_state.partial.clear();
+            return !run_state.done;
+        }
+    };
+
+    constexpr auto operator()() const -> transducer_t<reducer_t, void>
+    {
+        return {};
+    }
+};
+
+struct intersperse_fn
+{
+    template <class Reducer, class Separator>
+    struct reducer_t
+    {
+        Reducer m_next_reducer;
+        Separator m_separator;
+
+        struct run_state_type
+        {
+            bool started = false;
+            run_state_t<Reducer> next = {};
+        };
+
+        template <class State, class Arg>
+        constexpr auto operator()(State& state, run_state_type& run_state, Arg&& arg) const -> bool
+        {
+            if (run_state.started)
+            {
+                if (!invoke_reducer(m_next_reducer, state, run_state.next, m_separator))
+                {
+                    return false;
+                }
+            }
+            run_state.started = true;
+            return invoke_reducer(m_next_reducer, state, run_state.next, std::forward<Arg>(arg));
+        }
+
+        template <class State>
+        constexpr void complete(State& state, run_state_type& run_state) const
+        {
+            complete_reducer(m_next_reducer, state, run_state.next);
+        }
+    };
+
+    template <class Separator>
+    constexpr auto operator()(Separator&& separator) const -> transducer_t<reducer_t, std::decay_t<Separator>>
+    {
+        return { std::forward<Separator>(separator) };
+    }
+};
+
+struct all_of_fn
+{
+    template <class Pred>
+    struct reducer_t
+    {
+        Pred m_pred;
+
+        template <class... Args>
+        constexpr auto operator()(bool& state, Args&&... args) const -> bool
+        {
+            state = state && detail::invoke(m_pred, std::forward<Args>(args)...);
+            return state;
+        }
+    };
+
+    template <class Pred>
+    constexpr auto operator()(Pred&& pred) const -> reductor_t<bool, reducer_t<std::decay_t<Pred>>>
+    {
+        return { true, reducer_t<std::decay_t<Pred>>{ std::forward<Pred>(pred) } };
+    }
+};
+
+struct any_of_fn
+{
+    template <class Pred>
+    struct reducer_t
+    {
+        Pred m_pred;
+
+        template <class... Args>
+        constexpr auto operator()(bool& state, Args&&... args) const -> bool
+        {
+            state = state || detail::invoke(m_pred, std::forward<Args>(args)...);
+            return !state;
+        }
+    };
+
+    template <class Pred>
+    constexpr auto operator()(Pred&& pred) const -> reductor_t<bool, reducer_t<std::decay_t<Pred>>>
+    {
+        return { false, reducer_t<std::decay_t<Pred>>{ std::forward<Pred>(pred) } };
+    }
+};
+
+struct none_of_fn
+{
+    template <class Pred>
+    struct reducer_t
+    {
+        Pred m_pred;
+
+        template <class... Args>
+        constexpr auto operator()(bool& state, Args&&... args) const -> bool
+        {
+            state = state && !detail::invoke(m_pred, std::forward<Args>(args)...);
+            return state;
+        }
+    };
+
+    template <class Pred>
+    constexpr auto operator()(Pred&& pred) const -> reductor_t<bool, reducer_t<std::decay_t<Pred>>>
+    {
+        return { true, reducer_t<std::decay_t<Pred>>{ std::forward<Pred>(pred) } };
+    }
+};
+
+struct ignoring_reducer_t
+{
+    template <class State, class... Args>
+    constexpr auto operator()(State&, Args&&...) const -> bool
+    {
+        return true;
+    }
+};
+
+struct copy_to_reducer_t
+{
+    template <class State, class Arg>
+    constexpr auto operator()(State& state, Arg&& arg) const -> bool
+    {
+        *state = std::forward<Arg>(arg);
+        ++state;
+        return true;
+    }
+};
+
+struct deref_fn
+{
+    template <class T>
+    constexpr auto operator()(T& arg) const -> T&
+    {
+        return arg;
+    }
+
+    template <class T>
+    constexpr auto operator()(T* arg) const -> T&
+    {
+        return *arg;
+    }
+
+    template <class T>
+    constexpr auto operator()(std::reference_wrapper<T> arg) const -> T&
+    {
+        return (*this)(arg.get());
+    }
+};
+
+static constexpr inline auto deref = deref_fn{};
+
+struct push_reducer_t
+{
+    template <class State, class... Args>
+    constexpr auto operator()(State& state, Args&&... args) const -> bool
+    {
+        state.push(std::forward<Args>(args)...);
+        return true;
+    }
+};
+
+struct write_lines_fn
+{
+    struct reducer_t
+    {
+        template <class... Args>
+        auto operator()(line_writer& state, Args&&... args) const -> bool
+        {
+            state.push(args...);
+            return true;
+        }
+
+        void complete(line_writer& state) const
+        {
+            state.flush();
+        }
+    };
+
+    auto operator()(std::ostream& stream, std::string separator = " ", std::size_t buffer_size = 1 << 16) const
+        -> reductor_t<line_writer, reducer_t>
+    {
+        return { line_writer{ stream, std::move(separator), buffer_size }, {} };
+    }
+
+#ifdef TRX_HAS_POSIX
+    auto operator()(int fd, std::string separator = " ", std::size_t buffer_size = 1 << 16) const
+        -> reductor_t<line_writer, reducer_t>
+    {
+        return { line_writer{ fd, std::move(separator), buffer_size }, {} };
+    }
+#endif  // TRX_HAS_POSIX
+};
+
+template <class... Ts>
+struct write_columns_fn
+{
+    struct reducer_t
+    {
+        template <class... Args>
+        auto operator()(column_writer<Ts...>& state, Args&&... args) const -> bool
+        {
+            state.push(args...);
+            return true;
+        }
+
+        void complete(column_writer<Ts...>& state) const
+        {
+            state.flush();
+        }
+    };
+
+    auto operator()(std::ostream& stream, std::size_t block_rows = 1 << 16, bool statistics = true) const
+        -> reductor_t<column_writer<Ts...>, reducer_t>
+    {
+        return { column_writer<Ts...>{ stream, block_rows, statistics }, {} };
+    }
+};
+
+#ifdef TRX_HAS_POSIX
+
+// Read-only memory mapping of a whole file.
+class mapped_file
+{
+public:
+    explicit mapped_file(const std::string& path)
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw std::system_error{ errno, std::generic_category(), path };
+        }
+        struct stat info = {};
+        if (::fstat(fd, &info) != 0)
+        {
+            const int error = errno;
+            ::close(fd);
+            throw std::system_error{ error, std::generic_category(), path };
+        }
+        m_size = static_cast<std::size_t>(info.st_size);
+        if (m_size > 0)
+        {
+            void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED)
+            {
+                const int error = errno;
+                ::close(fd);
+                throw std::system_error{ error, std::generic_category(), path };
+            }
+            m_data = static_cast<const char*>(data);
+        }
+        ::close(fd);
+    }
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    ~mapped_file()
+    {
+        if (m_data)
+        {
+            ::munmap(const_cast<char*>(m_data), m_size);
+        }
+    }
+
+    auto data() const -> const char*
+    {
+        return m_data;
+    }
+
+    auto size() const -> std::size_t
+    {
+        return m_size;
     }
+
+private:
+    const char* m_data = nullptr;
+    std::size_t m_size = 0;
 };
 
-struct range_fn
+template <class... Ts>
+struct read_columns_fn
 {
+    struct block_t
+    {
+        std::size_t rows;
+        std::vector<const char*> statistics;
+        std::vector<const char*> values;
+    };
+
+    struct format_t
+    {
+        bool statistics;
+        std::vector<column_type> types;
+    };
+
+    static void check(bool condition, const char* message)
+    {
+        if (!condition)
+        {
+            throw std::runtime_error{ message };
+        }
+    }
+
+    static auto read_header(const mapped_file& file, std::size_t& offset) -> format_t
+    {
+        check(file.size() >= 20 && std::memcmp(file.data(), column_magic, 4) == 0, "read_columns: not a columnar file");
+        check(load<std::uint32_t>(file.data() + 4) == column_version, "read_columns: unsupported version");
+        const auto columns = load<std::uint32_t>(file.data() + 8);
+        const auto flags = load<std::uint32_t>(file.data() + 16);
+        offset = 20 + columns;
+        check(offset <= file.size(), "read_columns: truncated header");
+        format_t format{ (flags & 1) != 0, std::vector<column_type>(columns) };
+        std::memcpy(format.types.data(), file.data() + 20, columns);
+        for (const column_type type : format.types)
+        {
+            check(type <= column_type::f64, "read_columns: unknown column type");
+        }
+        return format;
+    }
+
+    static auto read_block(const mapped_file& file, const format_t& format, std::size_t& offset) -> block_t
+    {
+        check(offset + 4 <= file.size(), "read_columns: truncated block");
+        block_t block{ load<std::uint32_t>(file.data() + offset), {}, {} };
+        offset += 4;
+        for (const column_type type : format.types)
+        {
+            const std::size_t width = column_width(type);
+            block.statistics.push_back(file.data() + offset);
+            offset += format.statistics ? 2 * width : 0;
+            block.values.push_back(file.data() + offset);
+            offset += block.rows * width;
+        }
+        check(offset <= file.size(), "read_columns: truncated block");
+        return block;
+    }
+
     template <class T>
-    constexpr auto operator()(T lower, T upper) const -> generator_t<T>
+    static void check_type(const format_t& format, std::size_t column)
     {
-        using generator_type = generator_t<T>;
-        return generator_type(
+        check(column < format.types.size(), "read_columns: no such column");
+        check(format.types[column] == column_type_of<T>(), "read_columns: column type mismatch");
+    }
+
+    template <class T>
+    static auto may_match(const format_t& format, const block_t& block, const column_range<T>& range) -> bool
+    {
+        if (!format.statistics)
+        {
+            return true;
+        }
+        const char* statistics = block.statistics[range.column];
+        return !(load<T>(statistics + sizeof(T)) < range.min) && !(range.max < load<T>(statistics));
+    }
+
+    template <class T>
+    static auto matches(const block_t& block, std::size_t row, const column_range<T>& range) -> bool
+    {
+        const T value = load<T>(block.values[range.column] + row * sizeof(T));
+        return range.min <= value && value <= range.max;
+    }
+
+    template <class... Filters>
+    auto operator()(std::string path, std::array<std::size_t, sizeof...(Ts)> columns, Filters... filters) const
+        -> generator_t<Ts...>
+    {
+        return generator_t<Ts...>(
             [=](auto yield)
             {
-                for (T value = lower; value < upper; ++value)
+                const mapped_file file{ path };
+                std::size_t offset = 0;
+                const format_t format = read_header(file, offset);
+                std::apply([&](auto... column) { (check_type<Ts>(format, column), ...); }, columns);
+                (check_type<decltype(filters.min)>(format, filters.column), ...);
+
+                while (offset < file.size())
                 {
-                    if (!yield(value))
+                    const block_t block = read_block(file, format, offset);
+                    if (!(may_match(format, block, filters) && ...))
                     {
-                        return;
+                        continue;
+                    }
+                    for (std::size_t row = 0; row < block.rows; ++row)
+                    {
+                        if (!(matches(block, row, filters) && ...))
+                        {
+                            continue;
+                        }
+                        if (!yield_row(yield, block, row, columns, std::index_sequence_for<Ts...>{}))
+                        {
+                            return;
+                        }
                     }
                 }
             });
     }
 
-    template <class T>
-    constexpr auto operator()(T upper) const -> generator_t<T>
+    template <class Yield, std::size_t... I>
+    static auto yield_row(
+        Yield& yield,
+        const block_t& block,
+        std::size_t row,
+        const std::array<std::size_t, sizeof...(Ts)>& columns,
+        std::index_sequence<I...>) -> bool
     {
-        return (*this)(T{}, upper);
+        return yield(load<Ts>(block.values[columns[I]] + row * sizeof(Ts))...);
     }
 };
 
-struct iota_fn
+struct read_blocks_fn
 {
-    template <class T = std::ptrdiff_t>
-    constexpr auto operator()(T lower = {}) const -> generator_t<T>
+    auto operator()(int fd, std::size_t block_size = 1 << 20) const -> generator_t<span<const char>>
     {
-        using generator_type = generator_t<T>;
-        return generator_type(
+        return generator_t<span<const char>>(
             [=](auto yield)
             {
-                T value = lower;
-                while (true)
+                block_reader reader{ fd, block_size };
+                for (span<const char> block = reader.next(); !block.empty(); block = reader.next())
                 {
-                    if (!yield(value))
+                    if (!yield(block))
                     {
                         return;
                     }
-                    ++value;
                 }
             });
     }
 };
 
-struct read_lines_fn
+#endif  // TRX_HAS_POSIX
+
+template <class Container, class = void>
+struct has_reserve_member : std::false_type
 {
-    static auto read_line(std::istream& in, std::string& line) -> std::istream&
+};
+
+template <class Container>
+struct has_reserve_member<Container, std::void_t<decltype(std::declval<Container&>().reserve(std::size_t{}))>>
+    : std::true_type
+{
+};
+
+template <class Container>
+constexpr void reserve_more(Container& container, std::size_t size)
+{
+    if constexpr (has_reserve_member<Container>::value)
     {
-        line.clear();
-        char ch;
+        container.reserve(container.size() + size);
+    }
+}
 
-        while (true)
-        {
-            if (!in.get(ch))
-            {
-                if (!line.empty())
-                {
-                    in.clear(in.rdstate() & ~std::ios::failbit);
-                    in.setstate(std::ios::eofbit);
-                    return in;
-                }
+struct push_back_reducer_t
+{
+    template <class State, class Arg>
+    constexpr auto operator()(State& state, Arg&& arg) const -> bool
+    {
+        deref(state).push_back(std::forward<Arg>(arg));
+        return true;
+    }
 
-                in.setstate(std::ios::failbit);
-                return in;
-            }
+    template <class State>
+    constexpr void reserve(State& state, std::size_t size) const
+    {
+        reserve_more(deref(state), size);
+    }
+};
 
-            if (ch == '\n')
+struct copy_to_fn
+{
+    template <class Out>
+    constexpr auto operator()(Out out) const -> reductor_t<Out, copy_to_reducer_t>
+    {
+        return { std::move(out), copy_to_reducer_t{} };
+    }
+};
+
+struct push_back_fn
+{
+    template <class Container>
+    constexpr auto operator()(Container& container) const
+        -> reductor_t<std::reference_wrapper<Container>, push_back_reducer_t>
+    {
+        return { container, push_back_reducer_t{} };
+    }
+};
+
+struct into_fn
+{
+    template <class Container>
+    constexpr auto operator()(Container&& container) const -> reductor_t<std::decay_t<Container>, push_back_reducer_t>
+    {
+        return { std::forward<Container>(container), push_back_reducer_t{} };
+    }
+};
+
+struct into_columns_fn
+{
+    struct reducer_t
+    {
+        template <class... Columns, class... Args>
+        constexpr auto operator()(std::tuple<Columns...>& state, Args&&... args) const -> bool
+        {
+            if constexpr (sizeof...(Args) == 1 && sizeof...(Columns) > 1)
             {
-                return in;
+                std::apply([&](auto&&... values) { push(state, std::forward<decltype(values)>(values)...); }, args...);
             }
-
-            if (ch == '\r')
+            else
             {
-                if (in.peek() == '\n')
-                {
-                    in.get();
-                }
-
-                return in;
+                push(state, std::forward<Args>(args)...);
             }
+            return true;
+        }
 
-            line.push_back(ch);
+        template <class... Columns>
+        constexpr void reserve(std::tuple<Columns...>& state, std::size_t size) const
+        {
+            std::apply([&](auto&... columns) { (reserve_more(deref(columns), size), ...); }, state);
         }
+
+        template <class... Columns, class... Args>
+        static constexpr void push(std::tuple<Columns...>& state, Args&&... args)
+        {
+            static_assert(sizeof...(Columns) == sizeof...(Args), "into_columns: one value per column expected");
+            std::apply([&](auto&... columns) { (deref(columns).push_back(std::forward<Args>(args)), ...); }, state);
+        }
+    };
+
+    template <class... Columns>
+    constexpr auto operator()(Columns&&... columns) const -> reductor_t<std::tuple<std::decay_t<Columns>...>, reducer_t>
+    {
+        return { std::tuple<std::decay_t<Columns>...>{ std::forward<Columns>(columns)... }, {} };
     }
+};
 
-    auto operator()(std::istream& is) const -> generator_t<std::string>
+struct partition_fn
+{
+    template <class Pred, class OnTrueReducer, class OnFalseReducer>
+    struct reducer_t
     {
-        using generator_type = generator_t<std::string>;
-        return generator_type(
-            [&](auto yield)
+        Pred m_pred;
+        std::tuple<OnTrueReducer, OnFalseReducer> m_reducers;
+
+        struct run_state_type
+        {
+            std::bitset<2> done = {};
+            std::tuple<run_state_t<OnTrueReducer>, run_state_t<OnFalseReducer>> next = {};
+        };
+
+        template <class State, class... Args>
+        constexpr auto operator()(State& state, run_state_type& run_state, Args&&... args) const -> bool
+        {
+            if (detail::invoke(m_pred, args...))
             {
-                std::string line;
-                while (read_line(is, line))
+                if (!run_state.done[0])
                 {
-                    if (!yield(line))
-                    {
-                        return;
-                    }
+                    run_state.done[0] = !invoke_reducer(
+                        std::get<0>(m_reducers), state.first, std::get<0>(run_state.next), std::forward<Args>(args)...);
                 }
-            });
+            }
+            else
+            {
+                if (!run_state.done[1])
+                {
+                    run_state.done[1] = !invoke_reducer(
+                        std::get<1>(m_reducers), state.second, std::get<1>(run_state.next), std::forward<Args>(args)...);
+                }
+            }
+            return !run_state.done.all();
+        }
+
+        template <class State>
+        constexpr void complete(State& state, run_state_type& run_state) const
+        {
+            complete_reducer(std::get<0>(m_reducers), state.first, std::get<0>(run_state.next));
+            complete_reducer(std::get<1>(m_reducers), state.second, std::get<1>(run_state.next));
+        }
+    };
+
+    template <class Pred, class S0, class R0, class S1, class R1>
+    constexpr auto operator()(Pred&& pred, reductor_t<S0, R0> on_true_reducer, reductor_t<S1, R1> on_false_reducer) const
+        -> reductor_t<std::pair<S0, S1>, reducer_t<std::decay_t<Pred>, R0, R1>>
+    {
+        return { { std::move(on_true_reducer.state), std::move(on_false_reducer.state) },
+                 { std::forward<Pred>(pred), { std::move(on_true_reducer.reducer), std::move(on_false_reducer.reducer) } } };
     }
 };
 
-template <template <class...> class R, class Arg>
-struct transducer_t
+struct fork_fn
 {
-    Arg m_arg;
-
-    template <class Reducer>
-    constexpr auto operator()(Reducer&& next_reducer) const& -> R<std::decay_t<Reducer>, Arg>
+    template <class... Reducers>
+    struct reducer_t
     {
-        return {
-            std::forward<Reducer>(next_reducer),
-            m_arg,
+        std::tuple<Reducers...> m_reducers;
+
+        struct run_state_type
+        {
+            std::bitset<sizeof...(Reducers)> done = {};
+            std::tuple<run_state_t<Reducers>...> next = {};
         };
+
+        template <std::size_t N, class State, class... Args>
+        void call(State& state, run_state_type& run_state, Args&&... args) const
+        {
+            if (!run_state.done[N])
+            {
+                run_state.done[N]
+                    = !invoke_reducer(std::get<N>(m_reducers), std::get<N>(state), std::get<N>(run_state.next), args...);
+            }
+            if constexpr (N + 1 < sizeof...(Reducers))
+            {
+                call<N + 1>(state, run_state, args...);
+            }
+        }
+
+        template <class State, class... Args>
+        constexpr auto operator()(State& state, run_state_type& run_state, Args&&... args) const -> bool
+        {
+            call<0>(state, run_state, args...);
+            return !run_state.done.all();
+        }
+
+        template <class State, std::size_t... I>
+        constexpr void complete(State& state, run_state_type& run_state, std::index_sequence<I...>) const
+        {
+            (complete_reducer(std::get<I>(m_reducers), std::get<I>(state), std::get<I>(run_state.next)), ...);
+        }
+
+        template <class State>
+        constexpr void complete(State& state, run_state_type& run_state) const
+        {
+            complete(state, run_state, std::index_sequence_for<Reducers...>{});
+        }
+    };
+
+    template <class... Reducers>
+    constexpr auto operator()(Reducers... reducers) const
+        -> reductor_t<std::tuple<typename Reducers::state_type...>, reducer_t<typename Reducers::reducer_type...>>
+    {
+        return { { std::move(reducers.state)... },
+                 {
+                     { std::move(reducers.reducer)... },
+                 } };
     }
+};
 
-    template <class Reducer>
-    constexpr auto operator()(Reducer&& next_reducer) && -> R<std::decay_t<Reducer>, Arg>
+// Key type of a key function, or void if it can't be deduced from the function alone (a generic lambda, an overloaded
+// call operator); such key functions are either invoked with the items to deduce it, or wrapped in `key_as<Key>`.
+template <class Func, class = void>
+struct key_type_impl
+{
+    using type = void;
+};
+
+template <class Func>
+struct key_type_impl<Func, std::void_t<return_type_t<Func>>>
+{
+    using type = std::decay_t<return_type_t<Func>>;
+};
+
+template <class Member, class Class>
+struct key_type_impl<Member Class::*>
+{
+    using type = std::decay_t<std::invoke_result_t<Member Class::*, const Class&>>;
+};
+
+template <class Key, class Func>
+struct key_as_t
+{
+    Func m_func;
+
+    template <class... Args>
+    constexpr auto operator()(Args&&... args) const -> Key
     {
-        return {
-            std::forward<Reducer>(next_reducer),
-            std::move(m_arg),
-        };
+        return detail::invoke(m_func, std::forward<Args>(args)...);
     }
 };
 
-template <template <class...> class R>
-struct transducer_t<R, void>
+template <class Key, class Func>
+struct key_type_impl<key_as_t<Key, Func>>
+{
+    using type = Key;
+};
+
+template <class Key>
+struct key_as_fn
 {
-    template <class Reducer>
-    constexpr auto operator()(Reducer&& next_reducer) const& -> R<std::decay_t<Reducer>>
+    template <class Func>
+    constexpr auto operator()(Func&& func) const -> key_as_t<Key, std::decay_t<Func>>
     {
-        return { std::forward<Reducer>(next_reducer) };
+        return { std::forward<Func>(func) };
     }
+};
 
-    template <class Reducer>
-    constexpr auto operator()(Reducer&& next_reducer) && -> R<std::decay_t<Reducer>>
-    {
-        return { std::forward<Reducer>(next_reducer) };
-    }
+template <class Func>
+using key_type_t = typename key_type_impl<std::decay_t<Func>>::type;
+
+// Key type of a key function which is needed before any item is seen, e.g. for the type of the resulting state.
+template <class Func>
+struct required_key_type
+{
+    static_assert(
+        !std::is_void_v<key_type_t<Func>>,
+        "The key type can't be deduced from the key function; wrap it in trx::key_as<Key>(key_fn).");
+    using type = key_type_t<Func>;
 };
 
-struct filter_fn
+template <class Func>
+using required_key_type_t = typename required_key_type<Func>::type;
+
+struct group_by_fn
 {
-    template <class Reducer, class Pred>
+    template <class KeyFn, class GroupState, class Reducer>
     struct reducer_t
     {
-        Reducer m_next_reducer;
-        Pred m_pred;
+        KeyFn m_key_fn;
+        GroupState m_init;
+        Reducer m_reducer;
+
+        struct group_run_state_t
+        {
+            bool done = false;
+            run_state_t<Reducer> next = {};
+        };
+
+        struct run_state_type
+        {
+            std::vector<group_run_state_t> groups = {};
+        };
 
         template <class State, class... Args>
-        constexpr auto operator()(State& state, Args&&... args) const -> bool
+        auto operator()(State& state, run_state_type& run_state, Args&&... args) const -> bool
         {
-            if (std::invoke(m_pred, args...))
+            const auto it = state.try_emplace(detail::invoke(m_key_fn, args...), m_init).first;
+            const auto index = static_cast<std::size_t>(it - state.begin());
+            if (index >= run_state.groups.size())
+            {
+                run_state.groups.resize(index + 1);
+            }
+            group_run_state_t& group = run_state.groups[index];
+            if (!group.done)
             {
-                return m_next_reducer(state, std::forward<Args>(args)...);
+                group.done = !invoke_reducer(m_reducer, it->second, group.next, std::forward<Args>(args)...);
             }
             return true;
         }
+
+        template <class State>
+        void complete(State& state, run_state_type& run_state) const
+        {
+            run_state.groups.resize(state.size());
+            auto it = state.begin();
+            for (group_run_state_t& group : run_state.groups)
+            {
+                complete_reducer(m_reducer, (it++)->second, group.next);
+            }
+        }
     };
 
-    template <class Pred>
-    constexpr auto operator()(Pred&& pred) const -> transducer_t<reducer_t, std::decay_t<Pred>>
+    template <class KeyFn, class S, class R>
+    auto operator()(KeyFn&& key_fn, reductor_t<S, R> reductor) const
+        -> reductor_t<flat_hash_map<required_key_type_t<KeyFn>, S>, reducer_t<std::decay_t<KeyFn>, S, R>>
     {
-        return { std::forward<Pred>(pred) };
+        return { {}, { std::forward<KeyFn>(key_fn), std::move(reductor.state), std::move(reductor.reducer) } };
     }
 };
 
-struct filter_indexed_fn
+struct parallel_group_by_fn
 {
-    template <class Reducer, class Pred>
+    template <class KeyFn, class GroupState, class Reducer>
     struct reducer_t
     {
-        Reducer m_next_reducer;
-        Pred m_pred;
-        mutable std::ptrdiff_t m_index = 0;
+        KeyFn m_key_fn;
+        GroupState m_init;
+        Reducer m_reducer;
+
+        struct group_run_state_t
+        {
+            bool done = false;
+            run_state_t<Reducer> next = {};
+        };
+
+        struct run_state_type
+        {
+            std::vector<std::vector<group_run_state_t>> partitions = {};
+        };
 
         template <class State, class... Args>
-        constexpr auto operator()(State& state, Args&&... args) const -> bool
+        auto operator()(State& state, run_state_type& run_state, Args&&... args) const -> bool
         {
-            if (std::invoke(m_pred, m_index++, std::forward<Args>(args)...))
+            const auto& key = detail::invoke(m_key_fn, args...);
+            const auto hash = state.hash(key);
+            const auto partition_index = state.partition_of(hash);
+            auto& partition = state.partitions()[partition_index];
+            const auto it = partition.try_emplace_hashed(hash, key, m_init).first;
+            const auto index = static_cast<std::size_t>(it - partition.begin());
+            if (run_state.partitions.empty())
             {
-                return m_next_reducer(state, std::forward<Args>(args)...);
+                run_state.partitions.resize(state.partitions().size());
+            }
+            std::vector<group_run_state_t>& groups = run_state.partitions[partition_index];
+            if (index >= groups.size())
+            {
+                groups.resize(index + 1);
+            }
+            group_run_state_t& group = groups[index];
+            if (!group.done)
+            {
+                group.done = !invoke_reducer(m_reducer, it->second, group.next, std::forward<Args>(args)...);
             }
             return true;
         }
-    };
 
-    template <class Pred>
-    constexpr auto operator()(Pred&& pred) const -> transducer_t<reducer_t, std::decay_t<Pred>>
-    {
-        return { std::forward<Pred>(pred) };
-    }
-};
+        template <class State>
+        void complete(State& state, run_state_type& run_state) const
+        {
+            run_state.partitions.resize(state.partitions().size());
+            for (std::size_t p = 0; p < run_state.partitions.size(); ++p)
+            {
+                std::vector<group_run_state_t>& groups = run_state.partitions[p];
+                groups.resize(state.partitions()[p].size());
+                auto it = state.partitions()[p].begin();
+                for (group_run_state_t& group : groups)
+                {
+                    complete_reducer(m_reducer, (it++)->second, group.next);
+                }
+            }
+        }
+    };
 
-struct transform_fn
-{
-    template <class Reducer, class Func>
-    struct reducer_t
+    template <class Combine>
+    struct merge_t
     {
-        Reducer m_next_reducer;
-        Func m_func;
+        Combine m_combine;
+        std::size_t m_workers;
 
-        template <class State, class... Args>
-        constexpr auto operator()(State& state, Args&&... args) const -> bool
+        template <class State>
+        auto operator()(std::vector<State> states) const -> State
         {
-            return m_next_reducer(state, std::invoke(m_func, std::forward<Args>(args)...));
+            State result = std::move(states.front());
+            const auto partition_count = result.partitions().size();
+            const auto workers = std::min(m_workers, partition_count);
+            parallel_for(
+                workers,
+                [&](std::size_t worker)
+                {
+                    for (std::size_t p = worker; p < partition_count; p += workers)
+                    {
+                        auto& target = result.partitions()[p];
+                        for (std::size_t i = 1; i < states.size(); ++i)
+                        {
+                            for (auto& [key, value] : states[i].partitions()[p])
+                            {
+                                const auto [it, inserted]
+                                    = target.try_emplace_hashed(target.hash(key), key, std::move(value));
+                                if (!inserted)
+                                {
+                                    it->second = detail::invoke(m_combine, std::move(it->second), std::move(value));
+                                }
+                            }
+                        }
+                    }
+                });
+            return result;
         }
     };
 
-    template <class Func>
-    constexpr auto operator()(Func&& func) const -> transducer_t<reducer_t, std::decay_t<Func>>
+    template <class KeyFn, class S, class R, class Combine>
+    auto operator()(KeyFn&& key_fn, reductor_t<S, R> reductor, Combine&& combine, std::size_t workers = 0) const
+        -> parallel_reductor_t<
+            partitioned_hash_map<required_key_type_t<KeyFn>, S>,
+            reducer_t<std::decay_t<KeyFn>, S, R>,
+            merge_t<std::decay_t<Combine>>>
     {
-        return { std::forward<Func>(func) };
+        workers = worker_count(workers);
+        std::size_t partition_bits = 0;
+        while ((std::size_t{ 1 } << partition_bits) < workers * 4)
+        {
+            ++partition_bits;
+        }
+        return { { partitioned_hash_map<required_key_type_t<KeyFn>, S>{ partition_bits },
+                   { std::forward<KeyFn>(key_fn), std::move(reductor.state), std::move(reductor.reducer) } },
+                 { std::forward<Combine>(combine), workers },
+                 workers };
     }
 };
 
-struct transform_indexed_fn
+template <class T, class DefaultCompare>
+struct top_k_fn
 {
-    template <class Reducer, class Func>
-    struct reducer_t
-    {
-        Reducer m_next_reducer;
-        Func m_func;
-        mutable std::ptrdiff_t m_index = 0;
-
-        template <class State, class... Args>
-        constexpr auto operator()(State& state, Args&&... args) const -> bool
-        {
-            return m_next_reducer(state, std::invoke(m_func, m_index++, std::forward<Args>(args)...));
-        }
-    };
-
-    template <class Func>
-    constexpr auto operator()(Func&& func) const -> transducer_t<reducer_t, std::decay_t<Func>>
+    template <class Key = identity_fn, class Compare = DefaultCompare>
+    auto operator()(std::size_t k, Key&& key = {}, Compare&& compare = {}) const
+        -> reductor_t<bounded_heap<T, std::decay_t<Key>, std::decay_t<Compare>>, push_reducer_t>
     {
-        return { std::forward<Func>(func) };
+        return { bounded_heap<T, std::decay_t<Key>, std::decay_t<Compare>>{
+                     k, std::forward<Key>(key), std::forward<Compare>(compare) },
+                 push_reducer_t{} };
     }
 };
 
-struct inspect_fn
+template <class T>
+struct chunk_fn
 {
-    template <class Reducer, class Func>
+    template <class Reducer, class Size>
     struct reducer_t
     {
         Reducer m_next_reducer;
-        Func m_func;
+        Size m_size;
+
+        struct run_state_type
+        {
+            std::vector<T> buffer = {};
+            run_state_t<Reducer> next = {};
+        };
 
         template <class State, class... Args>
-        constexpr auto operator()(State& state, Args&&... args) const -> bool
+        auto operator()(State& state, run_state_type& run_state, Args&&... args) const -> bool
+        {
+            if (run_state.buffer.capacity() < m_size)
+            {
+                run_state.buffer.reserve(m_size);
+            }
+            run_state.buffer.emplace_back(std::forward<Args>(args)...);
+            return run_state.buffer.size() < m_size || flush(state, run_state);
+        }
+
+        template <class State>
+        void complete(State& state, run_state_type& run_state) const
+        {
+            if (!run_state.buffer.empty())
+            {
+                flush(state, run_state);
+            }
+            complete_reducer(m_next_reducer, state, run_state.next);
+        }
+
+    private:
+        template <class State>
+        auto flush(State& state, run_state_type& run_state) const -> bool
         {
-            std::invoke(m_func, args...);
-            return m_next_reducer(state, std::forward<Args>(args)...);
+            const bool result = invoke_reducer(
+                m_next_reducer, state, run_state.next, span<T>{ run_state.buffer.data(), run_state.buffer.size() });
+            run_state.buffer.clear();
+            return result;
         }
     };
 
-    template <class Func>
-    constexpr auto operator()(Func&& func) const -> transducer_t<reducer_t, std::decay_t<Func>>
+    // A size of 0 is treated as 1.
+    constexpr auto operator()(std::size_t size) const -> transducer_t<reducer_t, std::size_t>
     {
-        return { std::forward<Func>(func) };
+        return { std::max<std::size_t>(size, 1) };
     }
 };
 
-struct inspect_indexed_fn
+// Hash of a key which doesn't depend on the standard library implementation for integral, enumeration and string keys
+// (64-bit FNV-1a of the characters), so that the same key is mapped to the same shard across processes and platforms.
+// Other keys are hashed with std::hash.
+template <class Key>
+auto stable_hash(const Key& key, std::uint64_t seed) -> std::uint64_t
 {
-    template <class Reducer, class Func>
-    struct reducer_t
+    std::uint64_t h = 0;
+    if constexpr (std::is_integral_v<Key> || std::is_enum_v<Key>)
     {
-        Reducer m_next_reducer;
-        Func m_func;
-        mutable std::ptrdiff_t m_index = 0;
-
-        template <class State, class... Args>
-        constexpr auto operator()(State& state, Args&&... args) const -> bool
+        h = static_cast<std::uint64_t>(key);
+    }
+    else if constexpr (std::is_convertible_v<const Key&, std::string_view>)
+    {
+        h = 0xcbf29ce484222325ULL;
+        for (const char ch : std::string_view{ key })
         {
-            std::invoke(m_func, m_index++, args...);
-            return m_next_reducer(state, std::forward<Args>(args)...);
+            h = (h ^ static_cast<unsigned char>(ch)) * 0x100000001b3ULL;
         }
-    };
-
-    template <class Func>
-    constexpr auto operator()(Func&& func) const -> transducer_t<reducer_t, std::decay_t<Func>>
+    }
+    else
     {
-        return { std::forward<Func>(func) };
+        h = std::hash<Key>{}(key);
     }
-};
+    return fmix64(h + 0x9e3779b97f4a7c15ULL * (seed + 1));
+}
 
-struct transform_maybe_fn
+template <class T>
+struct shard_fn
 {
-    template <class Reducer, class Func>
+    template <class KeyFn>
+    struct params_t
+    {
+        KeyFn key_fn;
+        std::size_t batch_size;
+        std::uint64_t seed;
+    };
+
+    template <class KeyFn, class Reducer>
     struct reducer_t
     {
-        Reducer m_next_reducer;
-        Func m_func;
+        params_t<KeyFn> m_params;
+        Reducer m_reducer;
+
+        struct shard_run_state_t
+        {
+            std::vector<T> buffer = {};
+            bool done = false;
+            run_state_t<Reducer> next = {};
+        };
+
+        struct run_state_type
+        {
+            std::vector<shard_run_state_t> shards = {};
+            std::size_t done = 0;
+        };
 
         template <class State, class... Args>
-        constexpr auto operator()(State& state, Args&&... args) const -> bool
+        auto operator()(State& state, run_state_type& run_state, Args&&... args) const -> bool
         {
-            if (auto res = std::invoke(m_func, std::forward<Args>(args)...))
+            if (run_state.shards.empty())
             {
-                return m_next_reducer(state, *std::move(res));
+                run_state.shards.resize(state.states.size());
             }
-            return true;
+            const auto index = static_cast<std::size_t>(
+                stable_hash(detail::invoke(m_params.key_fn, args...), m_params.seed) % state.states.size());
+            ++state.counts[index];
+            shard_run_state_t& shard = run_state.shards[index];
+            if (!shard.done)
+            {
+                if (shard.buffer.capacity() < m_params.batch_size)
+                {
+                    shard.buffer.reserve(m_params.batch_size);
+                }
+                shard.buffer.emplace_back(std::forward<Args>(args)...);
+                if (shard.buffer.size() >= m_params.batch_size)
+                {
+                    flush(state, run_state, index);
+                }
+            }
+            return run_state.done < run_state.shards.size();
         }
-    };
-
-    template <class Func>
-    constexpr auto operator()(Func&& func) const -> transducer_t<reducer_t, std::decay_t<Func>>
-    {
-        return { std::forward<Func>(func) };
-    }
-};
-
-struct transform_maybe_indexed_fn
-{
-    template <class Reducer, class Func>
-    struct reducer_t
-    {
-        Reducer m_next_reducer;
-        Func m_func;
-        mutable std::ptrdiff_t m_index = 0;
 
-        template <class State, class... Args>
-        constexpr auto operator()(State& state, Args&&... args) const -> bool
+        template <class State>
+        void complete(State& state, run_state_type& run_state) const
         {
-            if (auto res = std::invoke(m_func, m_index++, std::forward<Args>(args)...))
+            run_state.shards.resize(state.states.size());
+            for (std::size_t index = 0; index < run_state.shards.size(); ++index)
             {
-                return m_next_reducer(state, *std::move(res));
+                if (!run_state.shards[index].done && !run_state.shards[index].buffer.empty())
+                {
+                    flush(state, run_state, index);
+                }
+                complete_reducer(m_reducer, state.states[index], run_state.shards[index].next);
             }
-            return true;
+        }
+
+    private:
+        template <class State>
+        void flush(State& state, run_state_type& run_state, std::size_t index) const
+        {
+            shard_run_state_t& shard = run_state.shards[index];
+            shard.done = !invoke_reducer(
+                m_reducer, state.states[index], shard.next, span<T>{ shard.buffer.data(), shard.buffer.size() });
+            run_state.done += shard.done ? 1 : 0;
+            shard.buffer.clear();
         }
     };
 
-    template <class Func>
-    constexpr auto operator()(Func&& func) const -> transducer_t<reducer_t, std::decay_t<Func>>
+    template <class KeyFn, class S, class R>
+    auto operator()(
+        std::size_t count,
+        KeyFn&& key_fn,
+        reductor_t<S, R> reductor,
+        std::size_t batch_size = 256,
+        std::uint64_t seed = 0) const -> reductor_t<sharded<S>, reducer_t<std::decay_t<KeyFn>, R>>
     {
-        return { std::forward<Func>(func) };
+        count = std::max<std::size_t>(count, 1);
+        return { sharded<S>{ std::vector<S>(count, std::move(reductor.state)), std::vector<std::size_t>(count) },
+                 { { std::forward<KeyFn>(key_fn), std::max<std::size_t>(batch_size, 1), seed },
+                   std::move(reductor.reducer) } };
     }
 };
 
-struct unpack_fn
+// Sorts `radix_keys` (pairs of a 64-bit key and an element index) by the lowest `bytes` bytes of the key with a stable
+// LSD radix sort. Passes in which all entries share the same digit are skipped.
+inline void radix_sort(std::vector<std::pair<std::uint64_t, std::size_t>>& radix_keys, std::size_t bytes)
 {
-    template <class Reducer>
-    struct reducer_t
+    std::vector<std::pair<std::uint64_t, std::size_t>> buffer(radix_keys.size());
+    for (std::size_t shift = 0; shift < bytes * 8; shift += 8)
     {
-        Reducer m_next_reducer;
-
-        template <class State, class Arg>
-        constexpr auto operator()(State& state, Arg&& arg) const -> bool
+        std::array<std::size_t, 256> offsets = {};
+        for (const auto& entry : radix_keys)
         {
-            return std::apply(
-                [&](auto&&... args) { return m_next_reducer(state, std::forward<decltype(args)>(args)...); },
-                std::forward<Arg>(arg));
+            ++offsets[(entry.first >> shift) & 0xFF];
         }
-    };
-
-    constexpr auto operator()() const -> transducer_t<reducer_t, void>
-    {
-        return {};
+        if (std::find(offsets.begin(), offsets.end(), radix_keys.size()) != offsets.end())
+        {
+            continue;
+        }
+        std::size_t offset = 0;
+        for (std::size_t& count : offsets)
+        {
+            offset += std::exchange(count, offset);
+        }
+        for (const auto& entry : radix_keys)
+        {
+            buffer[offsets[(entry.first >> shift) & 0xFF]++] = entry;
+        }
+        radix_keys.swap(buffer);
     }
-};
+}
 
-struct project_fn
+template <class T, std::enable_if_t<std::is_integral_v<T> || std::is_enum_v<T>, int> = 0>
+constexpr auto to_radix_key(T value) -> std::uint64_t
 {
-    template <class Reducer, class Funcs>
-    struct reducer_t
+    if constexpr (std::is_enum_v<T>)
     {
-        Reducer m_next_reducer;
-        Funcs m_funcs;
-
-        template <class State, class... Args>
-        constexpr auto operator()(State& state, Args&&... args) const -> bool
+        return to_radix_key(static_cast<std::underlying_type_t<T>>(value));
+    }
+    else if constexpr (std::is_same_v<T, bool>)
+    {
+        return value ? 1 : 0;
+    }
+    else
+    {
+        using unsigned_type = std::make_unsigned_t<T>;
+        auto result = static_cast<unsigned_type>(value);
+        if constexpr (std::is_signed_v<T>)
         {
-            return std::apply(
-                [&](auto&&... funcs) { return m_next_reducer(state, std::invoke(funcs, std::forward<Args>(args)...)...); },
-                m_funcs);
+            result ^= unsigned_type{ 1 } << (sizeof(T) * 8 - 1);
         }
-    };
+        return result;
+    }
+}
 
-    template <class... Funcs>
-    constexpr auto operator()(Funcs&&... funcs) const -> transducer_t<reducer_t, std::tuple<std::decay_t<Funcs>...>>
+// First 8 characters of a string packed big-endian, so that the integer order matches the lexicographical order.
+inline auto to_radix_key(std::string_view value) -> std::uint64_t
+{
+    std::uint64_t result = 0;
+    for (std::size_t i = 0; i < 8; ++i)
     {
-        return { std::make_tuple(std::forward<Funcs>(funcs)...) };
+        result = (result << 8) | (i < value.size() ? static_cast<unsigned char>(value[i]) : 0);
     }
-};
+    return result;
+}
 
-struct take_while_fn
+// Stable sort of a random access container by `key(element)`. Integral and enum keys are sorted with LSD radix sort,
+// string keys by a radix sort of their 8 byte prefixes followed by a comparison sort of runs of equal prefixes; other
+// keys fall back to `std::stable_sort`.
+template <class Container, class Key>
+void sort_by_key(Container& container, const Key& key)
 {
-    template <class Reducer, class Pred>
-    struct reducer_t
+    using value_type = typename Container::value_type;
+    using key_type = std::decay_t<std::invoke_result_t<const Key&, const value_type&>>;
+    constexpr bool is_integral_key = std::is_integral_v<key_type> || std::is_enum_v<key_type>;
+    constexpr bool is_string_key = std::is_convertible_v<const key_type&, std::string_view>;
+
+    const auto first = std::begin(container);
+    const auto size = static_cast<std::size_t>(std::distance(first, std::end(container)));
+    // String keys (including `const char*`) are compared by contents.
+    const auto less = [&](const value_type& lhs, const value_type& rhs) -> bool
     {
-        Reducer m_next_reducer;
-        Pred m_pred;
-
-        mutable bool m_done = false;
-
-        template <class State, class... Args>
-        constexpr auto operator()(State& state, Args&&... args) const -> bool
+        if constexpr (is_string_key)
         {
-            m_done |= !std::invoke(m_pred, args...);
-            if (!m_done)
-            {
-                return m_next_reducer(state, std::forward<Args>(args)...);
-            }
-            return false;
+            return std::string_view{ detail::invoke(key, lhs) } < std::string_view{ detail::invoke(key, rhs) };
+        }
+        else
+        {
+            return detail::invoke(key, lhs) < detail::invoke(key, rhs);
         }
     };
 
-    template <class Pred>
-    constexpr auto operator()(Pred&& pred) const -> transducer_t<reducer_t, std::decay_t<Pred>>
+    if constexpr (is_integral_key || is_string_key)
     {
-        return { std::forward<Pred>(pred) };
+        if (size >= 256)
+        {
+            std::vector<std::pair<std::uint64_t, std::size_t>> radix_keys(size);
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                radix_keys[i] = { to_radix_key(detail::invoke(key, first[i])), i };
+            }
+            radix_sort(radix_keys, is_integral_key ? sizeof(key_type) : 8);
+            if constexpr (is_string_key)
+            {
+                for (auto run = radix_keys.begin(); run != radix_keys.end();)
+                {
+                    const auto run_end = std::find_if(
+                        run, radix_keys.end(), [&](const auto& entry) { return entry.first != run->first; });
+                    if (run_end - run > 1)
+                    {
+                        std::stable_sort(
+                            run,
+                            run_end,
+                            [&](const auto& lhs, const auto& rhs) { return less(first[lhs.second], first[rhs.second]); });
+                    }
+                    run = run_end;
+                }
+            }
+            std::vector<value_type> sorted;
+            sorted.reserve(size);
+            for (const auto& entry : radix_keys)
+            {
+                sorted.push_back(std::move(first[entry.second]));
+            }
+            std::move(sorted.begin(), sorted.end(), first);
+            return;
+        }
     }
-};
+    std::stable_sort(first, std::end(container), less);
+}
 
-struct take_while_indexed_fn
+struct sorted_into_fn
 {
-    template <class Reducer, class Pred>
+    template <class Key>
     struct reducer_t
     {
-        Reducer m_next_reducer;
-        Pred m_pred;
+        Key m_key;
 
-        mutable bool m_done = false;
-        mutable std::ptrdiff_t m_index = 0;
+        template <class State, class Arg>
+        constexpr auto operator()(State& state, Arg&& arg) const -> bool
+        {
+            state.push_back(std::forward<Arg>(arg));
+            return true;
+        }
 
-        template <class State, class... Args>
-        constexpr auto operator()(State& state, Args&&... args) const -> bool
+        template <class State>
+        void complete(State& state) const
         {
-            m_done |= !std::invoke(m_pred, m_index++, args...);
-            if (!m_done)
-            {
-                return m_next_reducer(state, std::forward<Args>(args)...);
-            }
-            return false;
+            sort_by_key(state, m_key);
         }
     };
 
-    template <class Pred>
-    constexpr auto operator()(Pred&& pred) const -> transducer_t<reducer_t, std::decay_t<Pred>>
+    template <class Container, class Key = identity_fn>
+    constexpr auto operator()(Container&& container, Key&& key = {}) const
+        -> reductor_t<std::decay_t<Container>, reducer_t<std::decay_t<Key>>>
     {
-        return { std::forward<Pred>(pred) };
+        return { std::forward<Container>(container), { std::forward<Key>(key) } };
     }
 };
 
-struct drop_while_fn
+struct parallel_fn
 {
-    template <class Reducer, class Pred>
-    struct reducer_t
+    struct merge_states_t
     {
-        Reducer m_next_reducer;
-        Pred m_pred;
-
-        mutable bool m_done = false;
-
-        template <class State, class... Args>
-        constexpr auto operator()(State& state, Args&&... args) const -> bool
+        template <class State>
+        auto operator()(std::vector<State> states) const -> State
         {
-            m_done |= !std::invoke(m_pred, args...);
-            if (m_done)
+            State result = std::move(states.front());
+            for (std::size_t i = 1; i < states.size(); ++i)
             {
-                return m_next_reducer(state, std::forward<Args>(args)...);
+                result.merge(std::move(states[i]));
             }
-            return true;
+            return result;
         }
     };
 
-    template <class Pred>
-    constexpr auto operator()(Pred&& pred) const -> transducer_t<reducer_t, std::decay_t<Pred>>
-    {
-        return { std::forward<Pred>(pred) };
-    }
-};
-
-struct drop_while_indexed_fn
-{
-    template <class Reducer, class Pred>
-    struct reducer_t
+    template <class Combine>
+    struct fold_t
     {
-        Reducer m_next_reducer;
-        Pred m_pred;
-
-        mutable bool m_done = false;
-        mutable std::ptrdiff_t m_index = 0;
+        Combine m_combine;
 
-        template <class State, class... Args>
-        constexpr auto operator()(State& state, Args&&... args) const -> bool
+        template <class State>
+        auto operator()(std::vector<State> states) const -> State
         {
-            m_done |= !std::invoke(m_pred, m_index++, args...);
-            if (m_done)
+            State result = std::move(states.front());
+            for (std::size_t i = 1; i < states.size(); ++i)
             {
-                return m_next_reducer(state, std::forward<Args>(args)...);
+                result = detail::invoke(m_combine, std::move(result), std::move(states[i]));
             }
-            return true;
+            return result;
         }
     };
 
-    template <class Pred>
-    constexpr auto operator()(Pred&& pred) const -> transducer_t<reducer_t, std::decay_t<Pred>>
+    template <class S, class R>
+    auto operator()(reductor_t<S, R> reductor, std::size_t workers = 0) const -> parallel_reductor_t<S, R, merge_states_t>
     {
-        return { std::forward<Pred>(pred) };
+        return { std::move(reductor), {}, worker_count(workers) };
+    }
+
+    template <class S, class R, class Combine, std::enable_if_t<!std::is_integral_v<std::decay_t<Combine>>, int> = 0>
+    auto operator()(reductor_t<S, R> reductor, Combine&& combine, std::size_t workers = 0) const
+        -> parallel_reductor_t<S, R, fold_t<std::decay_t<Combine>>>
+    {
+        return { std::move(reductor), { std::forward<Combine>(combine) }, worker_count(workers) };
     }
 };
 
-struct take_fn
+// Transform evaluated by a pool of worker threads started with the run. At most `window` items are in flight. The
+// results are passed to the next reducer on the calling thread: in the input order through a reorder buffer if
+// Ordered, otherwise as soon as they are computed. Exceptions thrown by the function are rethrown on the calling thread.
+template <bool Ordered>
+struct parallel_transform_fn
 {
-    template <class Reducer, class>
+    template <class Func>
+    struct params_t
+    {
+        Func func;
+        std::size_t workers;
+        std::size_t window;
+    };
+
+    template <class Reducer, class Params>
     struct reducer_t
     {
+        using func_type = decltype(Params::func);
+
         Reducer m_next_reducer;
-        mutable std::ptrdiff_t m_count;
+        Params m_params;
 
-        template <class State, class... Args>
-        constexpr auto operator()(State& state, Args&&... args) const -> bool
+        struct pool_base_t
+        {
+            virtual ~pool_base_t() = default;
+        };
+
+        // The pool is type-erased in the run state, as it is the state type that selects the pool type. Items, and the
+        // results computed from them, are type-erased as well, so that items of different types can be pushed.
+        template <class State>
+        class pool_t : public pool_base_t
         {
-            if (m_count-- > 0)
+        public:
+            pool_t(const func_type& func, std::size_t workers, std::size_t window) : m_func{ func }, m_window{ window }
             {
-                return m_next_reducer(state, std::forward<Args>(args)...);
+                m_threads.reserve(workers);
+                try
+                {
+                    for (std::size_t worker = 0; worker < workers; ++worker)
+                    {
+                        m_threads.emplace_back([this] { work(); });
+                    }
+                }
+                catch (...)
+                {
+                    stop();
+                    throw;
+                }
             }
-            return false;
-        }
-    };
 
-    constexpr auto operator()(std::ptrdiff_t count) const -> transducer_t<reducer_t, std::ptrdiff_t>
-    {
-        return { count };
-    }
-};
+            ~pool_t() override
+            {
+                stop();
+            }
 
-struct drop_fn
-{
-    template <class Reducer, class>
-    struct reducer_t
-    {
-        Reducer m_next_reducer;
-        mutable std::ptrdiff_t m_count;
+            // Queues the input and passes the results available so far, waiting while the window is full.
+            template <class Input>
+            auto push(const Reducer& next_reducer, State& state, run_state_t<Reducer>& next, Input input) -> bool
+            {
+                auto task = std::make_unique<task_t<Input>>(std::move(input));
+                {
+                    std::lock_guard<std::mutex> lock{ m_mutex };
+                    m_jobs.push_back(job_t{ m_pushed++, std::move(task) });
+                    if constexpr (Ordered)
+                    {
+                        m_slots.emplace_back();
+                    }
+                    ++m_in_flight;
+                }
+                m_work_ready.notify_one();
+                return forward(next_reducer, state, next, m_window);
+            }
+
+            // Passes all the pending results to the next reducer.
+            auto drain(const Reducer& next_reducer, State& state, run_state_t<Reducer>& next) -> bool
+            {
+                return forward(next_reducer, state, next, 1);
+            }
+
+        private:
+            struct result_base_t
+            {
+                virtual ~result_base_t() = default;
+                virtual auto forward(const Reducer& next_reducer, State& state, run_state_t<Reducer>& next) -> bool = 0;
+            };
+
+            template <class T>
+            struct result_t : result_base_t
+            {
+                T m_value;
+
+                template <class U>
+                explicit result_t(U&& value) : m_value(std::forward<U>(value))
+                {
+                }
+
+                auto forward(const Reducer& next_reducer, State& state, run_state_t<Reducer>& next) -> bool override
+                {
+                    return invoke_reducer(next_reducer, state, next, std::move(m_value));
+                }
+            };
+
+            struct task_base_t
+            {
+                virtual ~task_base_t() = default;
+                virtual auto run(const func_type& func) -> std::unique_ptr<result_base_t> = 0;
+            };
+
+            template <class Input>
+            struct task_t : task_base_t
+            {
+                Input m_input;
+
+                explicit task_t(Input input) : m_input{ std::move(input) }
+                {
+                }
+
+                auto run(const func_type& func) -> std::unique_ptr<result_base_t> override
+                {
+                    using result_type = std::decay_t<decltype(std::apply(func, std::move(m_input)))>;
+                    return std::make_unique<result_t<result_type>>(std::apply(func, std::move(m_input)));
+                }
+            };
+
+            struct job_t
+            {
+                std::size_t index;
+                std::unique_ptr<task_base_t> task;
+            };
+
+            struct slot_t
+            {
+                std::unique_ptr<result_base_t> value = {};
+                std::exception_ptr error = {};
+                bool done = false;
+            };
+
+            void stop()
+            {
+                {
+                    std::lock_guard<std::mutex> lock{ m_mutex };
+                    m_stopping = true;
+                }
+                m_work_ready.notify_all();
+                for (std::thread& thread : m_threads)
+                {
+                    thread.join();
+                }
+            }
+
+            auto ready() const -> bool
+            {
+                if constexpr (Ordered)
+                {
+                    return !m_slots.empty() && m_slots.front().done;
+                }
+                else
+                {
+                    return !m_slots.empty();
+                }
+            }
+
+            // Passes the computed results to the next reducer, waiting for them while `limit` or more items are in flight.
+            auto forward(const Reducer& next_reducer, State& state, run_state_t<Reducer>& next, std::size_t limit) -> bool
+            {
+                while (true)
+                {
+                    slot_t slot;
+                    {
+                        std::unique_lock<std::mutex> lock{ m_mutex };
+                        if (m_in_flight >= limit)
+                        {
+                            m_result_ready.wait(lock, [&] { return ready(); });
+                        }
+                        else if (!ready())
+                        {
+                            return true;
+                        }
+                        slot = std::move(m_slots.front());
+                        m_slots.pop_front();
+                        ++m_forwarded;
+                        --m_in_flight;
+                    }
+                    if (slot.error)
+                    {
+                        std::rethrow_exception(slot.error);
+                    }
+                    if (!slot.value->forward(next_reducer, state, next))
+                    {
+                        return false;
+                    }
+                }
+            }
+
+            void work()
+            {
+                while (true)
+                {
+                    std::optional<job_t> job;
+                    {
+                        std::unique_lock<std::mutex> lock{ m_mutex };
+                        m_work_ready.wait(lock, [&] { return m_stopping || !m_jobs.empty(); });
+                        if (m_stopping)
+                        {
+                            return;
+                        }
+                        job.emplace(std::move(m_jobs.front()));
+                        m_jobs.pop_front();
+                    }
+                    slot_t slot;
+                    slot.done = true;
+                    try
+                    {
+                        slot.value = job->task->run(m_func);
+                    }
+                    catch (...)
+                    {
+                        slot.error = std::current_exception();
+                    }
+                    {
+                        std::lock_guard<std::mutex> lock{ m_mutex };
+                        if constexpr (Ordered)
+                        {
+                            m_slots[job->index - m_forwarded] = std::move(slot);
+                        }
+                        else
+                        {
+                            m_slots.push_back(std::move(slot));
+                        }
+                    }
+                    m_result_ready.notify_one();
+                }
+            }
+
+            const func_type m_func;
+            const std::size_t m_window;
+            std::mutex m_mutex = {};
+            std::condition_variable m_work_ready = {};
+            std::condition_variable m_result_ready = {};
+            std::deque<job_t> m_jobs = {};
+            // Ordered: results of the in-flight items in the input order. Unordered: computed results.
+            std::deque<slot_t> m_slots = {};
+            std::size_t m_pushed = 0;
+            std::size_t m_forwarded = 0;
+            std::size_t m_in_flight = 0;
+            bool m_stopping = false;
+            std::vector<std::thread> m_threads = {};
+        };
+
+        struct run_state_type
+        {
+            std::shared_ptr<pool_base_t> pool = {};
+            bool done = false;
+            run_state_t<Reducer> next = {};
+        };
+
+        template <class State>
+        static auto pool(run_state_type& run_state) -> pool_t<State>&
+        {
+            return static_cast<pool_t<State>&>(*run_state.pool);
+        }
 
         template <class State, class... Args>
-        constexpr auto operator()(State& state, Args&&... args) const -> bool
+        auto operator()(State& state, run_state_type& run_state, Args&&... args) const -> bool
         {
-            if (m_count-- <= 0)
+            if (!run_state.pool)
             {
-                return m_next_reducer(state, std::forward<Args>(args)...);
+                run_state.pool = std::make_shared<pool_t<State>>(m_params.func, m_params.workers, m_params.window);
             }
-            return true;
+            run_state.done = !pool<State>(run_state).push(
+                m_next_reducer, state, run_state.next, std::tuple<std::decay_t<Args>...>{ std::forward<Args>(args)... });
+            return !run_state.done;
+        }
+
+        template <class State>
+        void complete(State& state, run_state_type& run_state) const
+        {
+            if (run_state.pool && !run_state.done)
+            {
+                pool<State>(run_state).drain(m_next_reducer, state, run_state.next);
+            }
+            run_state.pool.reset();
+            complete_reducer(m_next_reducer, state, run_state.next);
+        }
+
+        template <class State>
+        void reserve(State& state, run_state_type& run_state, std::size_t size) const
+        {
+            reserve_reducer(m_next_reducer, state, run_state.next, size);
         }
     };
 
-    constexpr auto operator()(std::ptrdiff_t count) const -> transducer_t<reducer_t, std::ptrdiff_t>
+    template <class Func>
+    auto operator()(Func&& func, std::size_t workers = 0, std::size_t window = 0) const
+        -> transducer_t<reducer_t, params_t<std::decay_t<Func>>>
     {
-        return { count };
+        workers = worker_count(workers);
+        return { { std::forward<Func>(func), workers, window != 0 ? window : 2 * workers } };
     }
 };
 
-struct stride_fn
+struct distinct_fn
 {
-    template <class Reducer, class>
+    template <class Reducer, class KeyFn>
     struct reducer_t
     {
         Reducer m_next_reducer;
-        std::ptrdiff_t m_count;
-        mutable std::ptrdiff_t m_index = 0;
+        KeyFn m_key_fn;
+
+        using key_type = required_key_type_t<KeyFn>;
+
+        struct run_state_type
+        {
+            flat_hash_set<key_type> seen = {};
+            run_state_t<Reducer> next = {};
+        };
 
         template <class State, class... Args>
-        constexpr auto operator()(State& state, Args&&... args) const -> bool
+        auto operator()(State& state, run_state_type& run_state, Args&&... args) const -> bool
         {
-            if (m_index++ % m_count == 0)
+            if (run_state.seen.insert(detail::invoke(m_key_fn, args...)))
             {
-                return m_next_reducer(state, std::forward<Args>(args)...);
+                return invoke_reducer(m_next_reducer, state, run_state.next, std::forward<Args>(args)...);
             }
             return true;
         }
-    };
 
-    constexpr auto operator()(std::ptrdiff_t count) const -> transducer_t<reducer_t, std::ptrdiff_t>
-    {
-        return { count };
-    }
-};
+        template <class State>
+        void complete(State& state, run_state_type& run_state) const
+        {
+            complete_reducer(m_next_reducer, state, run_state.next);
+        }
+    };
 
-struct join_fn
-{
-    template <class Reducer>
-    struct reducer_t
+    template <class Reducer, class Params>
+    struct approximate_reducer_t
     {
         Reducer m_next_reducer;
+        Params m_params;
 
-        template <class State, class Arg>
-        constexpr auto operator()(State& state, Arg&& arg) const -> bool
+        struct run_state_type
         {
-            for (auto&& item : arg)
+            std::optional<bloom_filter> seen = {};
+            run_state_t<Reducer> next = {};
+        };
+
+        template <class State, class... Args>
+        auto operator()(State& state, run_state_type& run_state, Args&&... args) const -> bool
+        {
+            auto&& [key_fn, expected_items, false_positive_rate] = m_params;
+            if (!run_state.seen)
             {
-                if (!m_next_reducer(state, std::forward<decltype(item)>(item)))
-                {
-                    return false;
-                }
+                run_state.seen.emplace(expected_items, false_positive_rate);
+            }
+            const auto& key = detail::invoke(key_fn, args...);
+            if (run_state.seen->insert(mix_hash(std::hash<std::decay_t<decltype(key)>>{}(key))))
+            {
+                return invoke_reducer(m_next_reducer, state, run_state.next, std::forward<Args>(args)...);
             }
             return true;
         }
+
+        template <class State>
+        void complete(State& state, run_state_type& run_state) const
+        {
+            complete_reducer(m_next_reducer, state, run_state.next);
+        }
     };
 
-    constexpr auto operator()() const -> transducer_t<reducer_t, void>
+    template <class KeyFn>
+    constexpr auto operator()(KeyFn&& key_fn) const -> transducer_t<reducer_t, std::decay_t<KeyFn>>
     {
-        return {};
+        return { std::forward<KeyFn>(key_fn) };
     }
-};
 
-struct intersperse_fn
-{
-    template <class Reducer, class Separator>
-    struct reducer_t
+    // Bounded memory variant: forwards items whose key is not (probably) present in a Bloom filter, so a small fraction
+    // of first occurrences, controlled by `false_positive_rate`, may be dropped.
+    template <class KeyFn>
+    constexpr auto operator()(KeyFn&& key_fn, std::size_t expected_items, double false_positive_rate = 0.01) const
+        -> transducer_t<approximate_reducer_t, std::tuple<std::decay_t<KeyFn>, std::size_t, double>>
     {
-        Reducer m_next_reducer;
-        Separator m_separator;
-        mutable bool m_first = true;
-
-        template <class State, class Arg>
-        constexpr auto operator()(State& state, Arg&& arg) const -> bool
-        {
-            if (!m_first)
-            {
-                if (!m_next_reducer(state, m_separator))
-                {
-                    return false;
-                }
-            }
-            m_first = false;
-            return m_next_reducer(state, std::forward<Arg>(arg));
-        }
-    };
+        return { { std::forward<KeyFn>(key_fn), expected_items, false_positive_rate } };
+    }
+};
 
-    template <class Separator>
-    constexpr auto operator()(Separator&& separator) const -> transducer_t<reducer_t, std::decay_t<Separator>>
+struct approx_distinct_fn
+{
+    auto operator()(std::size_t precision = 14) const -> reductor_t<hyperloglog, push_reducer_t>
     {
-        return { std::forward<Separator>(separator) };
+        return { hyperloglog{ precision }, push_reducer_t{} };
     }
 };
 
-struct all_of_fn
+struct quantiles_fn
 {
-    template <class Pred>
-    struct reducer_t
+    auto operator()(double accuracy = 0.01) const -> reductor_t<quantile_sketch<double>, push_reducer_t>
     {
-        Pred m_pred;
+        return { quantile_sketch<double>{ accuracy }, push_reducer_t{} };
+    }
+};
 
-        template <class... Args>
-        constexpr auto operator()(bool& state, Args&&... args) const -> bool
+struct stats_fn
+{
+    struct reducer_t : push_reducer_t
+    {
+        // A contiguous range of numbers passed to `|=` directly is reduced block-wise.
+        template <class Range>
+        auto push_range(running_stats& state, const Range& range) const -> decltype(state.push(range))
         {
-            state = state && std::invoke(m_pred, std::forward<Args>(args)...);
-            return state;
+            state.push(range);
         }
     };
 
-    template <class Pred>
-    constexpr auto operator()(Pred&& pred) const -> reductor_t<bool, reducer_t<std::decay_t<Pred>>>
+    auto operator()() const -> reductor_t<running_stats, reducer_t>
     {
-        return { true, reducer_t<std::decay_t<Pred>>{ std::forward<Pred>(pred) } };
+        return { running_stats{}, reducer_t{} };
     }
 };
 
-struct any_of_fn
+// Build side of a hash join: rows grouped by key and stored contiguously, `groups` maps a key to its group index.
+template <class Key, class Value>
+struct hash_join_table_t
 {
-    template <class Pred>
-    struct reducer_t
-    {
-        Pred m_pred;
+    flat_hash_map<Key, std::size_t> groups = {};
+    std::vector<std::size_t> offsets = {};
+    std::vector<Value> rows = {};
 
-        template <class... Args>
-        constexpr auto operator()(bool& state, Args&&... args) const -> bool
+    auto matches(const Key& key) const -> span<const Value>
+    {
+        const auto it = groups.find(key);
+        if (it == groups.end())
         {
-            state = state || std::invoke(m_pred, std::forward<Args>(args)...);
-            return !state;
+            return {};
         }
-    };
-
-    template <class Pred>
-    constexpr auto operator()(Pred&& pred) const -> reductor_t<bool, reducer_t<std::decay_t<Pred>>>
-    {
-        return { false, reducer_t<std::decay_t<Pred>>{ std::forward<Pred>(pred) } };
+        return { rows.data() + offsets[it->second], offsets[it->second + 1] - offsets[it->second] };
     }
 };
 
-struct none_of_fn
+enum class join_mode
 {
-    template <class Pred>
+    inner,
+    left_outer,
+    semi
+};
+
+template <join_mode Mode>
+struct hash_join_fn
+{
+    template <class Reducer, class Params>
     struct reducer_t
     {
-        Pred m_pred;
+        Reducer m_next_reducer;
+        Params m_params;
 
-        template <class... Args>
-        constexpr auto operator()(bool& state, Args&&... args) const -> bool
+        using run_state_type = run_state_t<Reducer>;
+
+        template <class State, class... Args>
+        auto operator()(State& state, run_state_type& run_state, Args&&... args) const -> bool
         {
-            state = state && !std::invoke(m_pred, std::forward<Args>(args)...);
-            return state;
+            auto&& [table, probe_key] = m_params;
+            const auto matches = table->matches(detail::invoke(probe_key, std::as_const(args)...));
+            if constexpr (Mode == join_mode::semi)
+            {
+                return matches.empty() || invoke_reducer(m_next_reducer, state, run_state, std::forward<Args>(args)...);
+            }
+            else
+            {
+                if constexpr (Mode == join_mode::left_outer)
+                {
+                    if (matches.empty())
+                    {
+                        return invoke_reducer(
+                            m_next_reducer, state, run_state, std::as_const(args)..., decltype(matches.data()){});
+                    }
+                }
+                for (const auto& row : matches)
+                {
+                    if constexpr (Mode == join_mode::left_outer)
+                    {
+                        if (!invoke_reducer(m_next_reducer, state, run_state, std::as_const(args)..., &row))
+                        {
+                            return false;
+                        }
+                    }
+                    else if (!invoke_reducer(m_next_reducer, state, run_state, std::as_const(args)..., row))
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+        }
+
+        template <class State>
+        void complete(State& state, run_state_type& run_state) const
+        {
+            complete_reducer(m_next_reducer, state, run_state);
         }
     };
 
-    template <class Pred>
-    constexpr auto operator()(Pred&& pred) const -> reductor_t<bool, reducer_t<std::decay_t<Pred>>>
-    {
-        return { true, reducer_t<std::decay_t<Pred>>{ std::forward<Pred>(pred) } };
-    }
-};
+    template <class BuildSide, class BuildKey>
+    using build_key_t = std::decay_t<std::invoke_result_t<const BuildKey&, const source_value_t<BuildSide>&>>;
 
-struct ignoring_reducer_t
-{
-    template <class State, class... Args>
-    constexpr auto operator()(State&, Args&&...) const -> bool
+    // Collects the build side and groups the rows by key with a counting sort.
+    template <class BuildSide, class BuildKey, class ProbeKey>
+    auto operator()(BuildSide&& build_side, BuildKey&& build_key, ProbeKey&& probe_key) const -> transducer_t<
+        reducer_t,
+        std::tuple<std::shared_ptr<const hash_join_table_t<build_key_t<BuildSide, BuildKey>, source_value_t<BuildSide>>>,
+                   std::decay_t<ProbeKey>>>
     {
-        return true;
+        using value_type = source_value_t<BuildSide>;
+        auto table = std::make_shared<hash_join_table_t<build_key_t<BuildSide, BuildKey>, value_type>>();
+
+        std::vector<value_type> items;
+        std::vector<std::size_t> item_groups;
+        std::vector<std::size_t> counts;
+        zip_for_each(
+            [&](const value_type& item) -> bool
+            {
+                const auto it = table->groups.try_emplace(detail::invoke(build_key, item), counts.size()).first;
+                if (it->second == counts.size())
+                {
+                    counts.push_back(0);
+                }
+                ++counts[it->second];
+                item_groups.push_back(it->second);
+                items.push_back(item);
+                return true;
+            },
+            build_side);
+
+        table->offsets.resize(counts.size() + 1);
+        for (std::size_t group = 0; group < counts.size(); ++group)
+        {
+            table->offsets[group + 1] = table->offsets[group] + counts[group];
+        }
+        std::vector<std::size_t> positions(table->offsets.begin(), table->offsets.end() - 1);
+        std::vector<std::size_t> order(items.size());
+        for (std::size_t i = 0; i < items.size(); ++i)
+        {
+            order[positions[item_groups[i]]++] = i;
+        }
+        table->rows.reserve(items.size());
+        for (const std::size_t i : order)
+        {
+            table->rows.push_back(std::move(items[i]));
+        }
+        return { { std::move(table), std::forward<ProbeKey>(probe_key) } };
     }
 };
 
-struct copy_to_reducer_t
+// Throws std::invalid_argument unless `value` (a window size, width or hop) is positive.
+template <class T>
+void check_positive(T value, const char* message)
 {
-    template <class State, class Arg>
-    constexpr auto operator()(State& state, Arg&& arg) const -> bool
+    if (!(T{} < value))
     {
-        *state = std::forward<Arg>(arg);
-        ++state;
-        return true;
+        throw std::invalid_argument{ message };
     }
-};
+}
 
-struct deref_fn
+struct sliding_window_fn
 {
-    template <class T>
-    constexpr auto operator()(T& arg) const -> T&
+    template <class State, class Reducer, class Combine>
+    struct window_t
     {
-        return arg;
-    }
+        std::size_t size;
+        State init;
+        Reducer reducer;
+        Combine combine;
+    };
 
-    template <class T>
-    constexpr auto operator()(T* arg) const -> T&
+    struct merge_t
     {
-        return *arg;
-    }
+        template <class State>
+        auto operator()(State lhs, const State& rhs) const -> State
+        {
+            lhs.merge(rhs);
+            return lhs;
+        }
+    };
 
-    template <class T>
-    constexpr auto operator()(std::reference_wrapper<T> arg) const -> T&
+    // Two-stack aggregation: `back` holds single item states of the newest items along with their running aggregate,
+    // `front` holds suffix aggregates of the oldest items. Evicting an item pops `front`, refilling it from `back`
+    // when empty, so every item is combined a constant number of times.
+    template <class Reducer, class Window>
+    struct reducer_t
     {
-        return (*this)(arg.get());
-    }
-};
+        Reducer m_next_reducer;
+        Window m_window;
 
-static constexpr inline auto deref = deref_fn{};
+        using window_state_type = decltype(std::declval<Window>().init);
+        using window_reducer_type = decltype(std::declval<Window>().reducer);
 
-struct push_back_reducer_t
-{
-    template <class State, class Arg>
-    constexpr auto operator()(State& state, Arg&& arg) const -> bool
+        struct run_state_type
+        {
+            std::vector<window_state_type> front = {};
+            std::vector<window_state_type> back = {};
+            std::optional<window_state_type> back_aggregate = {};
+            run_state_t<window_reducer_type> back_run_state = {};
+            run_state_t<Reducer> next = {};
+        };
+
+        template <class State, class... Args>
+        auto operator()(State& state, run_state_type& run_state, Args&&... args) const -> bool
+        {
+            if (run_state.front.size() + run_state.back.size() >= m_window.size)
+            {
+                evict(run_state);
+            }
+
+            window_state_type item = m_window.init;
+            run_state_t<window_reducer_type> item_run_state = {};
+            invoke_reducer(m_window.reducer, item, item_run_state, args...);
+            run_state.back.push_back(std::move(item));
+
+            if (!run_state.back_aggregate)
+            {
+                run_state.back_aggregate.emplace(m_window.init);
+            }
+            invoke_reducer(m_window.reducer, *run_state.back_aggregate, run_state.back_run_state, args...);
+
+            if (run_state.front.empty())
+            {
+                return invoke_reducer(m_next_reducer, state, run_state.next, std::as_const(*run_state.back_aggregate));
+            }
+            const window_state_type aggregate
+                = detail::invoke(m_window.combine, run_state.front.back(), *run_state.back_aggregate);
+            return invoke_reducer(m_next_reducer, state, run_state.next, aggregate);
+        }
+
+        template <class State>
+        void complete(State& state, run_state_type& run_state) const
+        {
+            complete_reducer(m_next_reducer, state, run_state.next);
+        }
+
+    private:
+        void evict(run_state_type& run_state) const
+        {
+            if (run_state.front.empty())
+            {
+                for (auto it = run_state.back.rbegin(); it != run_state.back.rend(); ++it)
+                {
+                    run_state.front.push_back(
+                        run_state.front.empty() ? std::move(*it)
+                                                : detail::invoke(m_window.combine, std::move(*it), run_state.front.back()));
+                }
+                run_state.back.clear();
+                run_state.back_aggregate.reset();
+                run_state.back_run_state = {};
+            }
+            if (!run_state.front.empty())
+            {
+                run_state.front.pop_back();
+            }
+        }
+    };
+
+    template <class S, class R>
+    auto operator()(std::size_t size, reductor_t<S, R> reductor) const
+        -> transducer_t<reducer_t, window_t<S, R, merge_t>>
     {
-        deref(state).push_back(std::forward<Arg>(arg));
-        return true;
+        check_positive(size, "sliding_window: size must be positive");
+        return { { size, std::move(reductor.state), std::move(reductor.reducer), {} } };
     }
-};
 
-struct copy_to_fn
-{
-    template <class Out>
-    constexpr auto operator()(Out out) const -> reductor_t<Out, copy_to_reducer_t>
+    template <class S, class R, class Combine>
+    auto operator()(std::size_t size, reductor_t<S, R> reductor, Combine&& combine) const
+        -> transducer_t<reducer_t, window_t<S, R, std::decay_t<Combine>>>
     {
-        return { std::move(out), copy_to_reducer_t{} };
+        check_positive(size, "sliding_window: size must be positive");
+        return { { size, std::move(reductor.state), std::move(reductor.reducer), std::forward<Combine>(combine) } };
     }
 };
 
-struct push_back_fn
+// Start of the window of length `step` (aligned to zero or to the clock's epoch) containing `timestamp`.
+template <class T, class Step, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+constexpr auto floor_to(T timestamp, Step step) -> T
 {
-    template <class Container>
-    constexpr auto operator()(Container& container) const
-        -> reductor_t<std::reference_wrapper<Container>, push_back_reducer_t>
+    T remainder = static_cast<T>(timestamp % static_cast<T>(step));
+    if (remainder < 0)
     {
-        return { container, push_back_reducer_t{} };
+        remainder += static_cast<T>(step);
     }
-};
+    return static_cast<T>(timestamp - remainder);
+}
 
-struct into_fn
+template <class T, class Step, std::enable_if_t<std::is_floating_point_v<T>, int> = 0>
+auto floor_to(T timestamp, Step step) -> T
 {
-    template <class Container>
-    constexpr auto operator()(Container&& container) const -> reductor_t<std::decay_t<Container>, push_back_reducer_t>
+    return static_cast<T>(step) * std::floor(timestamp / static_cast<T>(step));
+}
+
+template <class Clock, class Duration, class Rep, class Period>
+constexpr auto floor_to(std::chrono::time_point<Clock, Duration> timestamp, std::chrono::duration<Rep, Period> step)
+    -> std::chrono::time_point<Clock, Duration>
+{
+    auto remainder = timestamp.time_since_epoch() % step;
+    if (remainder < remainder.zero())
     {
-        return { std::forward<Container>(container), push_back_reducer_t{} };
+        remainder += step;
     }
-};
+    return timestamp - std::chrono::duration_cast<Duration>(remainder);
+}
 
-struct partition_fn
+struct time_window_fn
 {
-    template <class Pred, class OnTrueReducer, class OnFalseReducer>
+    template <class TsFn, class Duration, class State, class Reducer>
+    struct params_t
+    {
+        TsFn ts_fn;
+        Duration width;
+        Duration hop;
+        Duration allowed_lateness;
+        State init;
+        Reducer reducer;
+    };
+
+    // Windows are opened on their first item and kept ordered by start. A window is emitted once the largest
+    // timestamp seen passes its end by `allowed_lateness`; items falling only into already emitted windows are dropped.
+    template <class Reducer, class Params>
     struct reducer_t
     {
-        Pred m_pred;
-        std::tuple<OnTrueReducer, OnFalseReducer> m_reducers;
-        mutable std::bitset<2> m_done{};
+        Reducer m_next_reducer;
+        Params m_params;
+
+        using timestamp_type = required_key_type_t<decltype(std::declval<Params>().ts_fn)>;
+        using window_state_type = decltype(std::declval<Params>().init);
+        using window_reducer_type = decltype(std::declval<Params>().reducer);
+
+        struct open_window_t
+        {
+            timestamp_type start;
+            window_state_type state;
+            run_state_t<window_reducer_type> run_state = {};
+        };
+
+        struct run_state_type
+        {
+            std::vector<open_window_t> windows = {};
+            std::optional<timestamp_type> watermark = {};
+            run_state_t<Reducer> next = {};
+        };
 
         template <class State, class... Args>
-        constexpr auto operator()(State& state, Args&&... args) const -> bool
+        auto operator()(State& state, run_state_type& run_state, Args&&... args) const -> bool
         {
-            if (std::invoke(m_pred, args...))
+            const timestamp_type timestamp = detail::invoke(m_params.ts_fn, args...);
+            if (!run_state.watermark || *run_state.watermark < timestamp)
             {
-                m_done[0] = !std::get<0>(m_reducers)(state.first, std::forward<Args>(args)...);
+                run_state.watermark = timestamp;
             }
-            else
+
+            for (timestamp_type start = floor_to(timestamp, m_params.hop); timestamp < start + m_params.width;
+                 start = start - m_params.hop)
+            {
+                if (is_closed(start, *run_state.watermark))
+                {
+                    break;
+                }
+                open_window_t& window = find_or_open(run_state.windows, start);
+                invoke_reducer(m_params.reducer, window.state, window.run_state, args...);
+            }
+
+            std::size_t closed = 0;
+            bool result = true;
+            while (result && closed < run_state.windows.size()
+                   && is_closed(run_state.windows[closed].start, *run_state.watermark))
             {
-                m_done[1] = !std::get<1>(m_reducers)(state.second, std::forward<Args>(args)...);
+                result = emit(state, run_state, run_state.windows[closed++]);
             }
-            return !m_done.all();
+            run_state.windows.erase(
+                run_state.windows.begin(), run_state.windows.begin() + static_cast<std::ptrdiff_t>(closed));
+            return result;
         }
-    };
 
-    template <class Pred, class S0, class R0, class S1, class R1>
-    constexpr auto operator()(Pred&& pred, reductor_t<S0, R0> on_true_reducer, reductor_t<S1, R1> on_false_reducer) const
-        -> reductor_t<std::pair<S0, S1>, reducer_t<std::decay_t<Pred>, R0, R1>>
-    {
-        return { { std::move(on_true_reducer.state), std::move(on_false_reducer.state) },
-                 { std::forward<Pred>(pred), { std::move(on_true_reducer.reducer), std::move(on_false_reducer.reducer) } } };
-    }
-};
+        template <class State>
+        void complete(State& state, run_state_type& run_state) const
+        {
+            for (open_window_t& window : run_state.windows)
+            {
+                if (!emit(state, run_state, window))
+                {
+                    break;
+                }
+            }
+            run_state.windows.clear();
+            complete_reducer(m_next_reducer, state, run_state.next);
+        }
 
-struct fork_fn
-{
-    template <class... Reducers>
-    struct reducer_t
-    {
-        std::tuple<Reducers...> m_reducers;
-        mutable std::bitset<sizeof...(Reducers)> m_done{};
+    private:
+        auto is_closed(const timestamp_type& start, const timestamp_type& watermark) const -> bool
+        {
+            return !(watermark < start + m_params.width + m_params.allowed_lateness);
+        }
 
-        template <std::size_t N, class State, class... Args>
-        void call(State& state, Args&&... args) const
+        auto find_or_open(std::vector<open_window_t>& windows, const timestamp_type& start) const -> open_window_t&
         {
-            m_done[N] = !std::get<N>(m_reducers)(std::get<N>(state), args...);
-            if constexpr (N + 1 < sizeof...(Reducers))
+            const auto it = std::lower_bound(
+                windows.begin(),
+                windows.end(),
+                start,
+                [](const open_window_t& window, const timestamp_type& value) { return window.start < value; });
+            if (it != windows.end() && !(start < it->start))
             {
-                call<N + 1>(state, args...);
+                return *it;
             }
+            return *windows.insert(it, open_window_t{ start, m_params.init });
         }
 
-        template <class State, class... Args>
-        constexpr auto operator()(State& state, Args&&... args) const -> bool
+        template <class State>
+        auto emit(State& state, run_state_type& run_state, open_window_t& window) const -> bool
         {
-            call<0>(state, args...);
-            return !m_done.all();
+            complete_reducer(m_params.reducer, window.state, window.run_state);
+            return invoke_reducer(
+                m_next_reducer,
+                state,
+                run_state.next,
+                time_window<timestamp_type, window_state_type>{
+                    window.start, window.start + m_params.width, std::move(window.state) });
         }
     };
+};
 
-    template <class... Reducers>
-    constexpr auto operator()(Reducers... reducers) const
-        -> reductor_t<std::tuple<typename Reducers::state_type...>, reducer_t<typename Reducers::reducer_type...>>
+struct tumbling_window_fn
+{
+    template <class TsFn, class Duration, class S, class R>
+    auto operator()(TsFn&& ts_fn, Duration width, reductor_t<S, R> reductor, Duration allowed_lateness = {}) const
+        -> transducer_t<time_window_fn::reducer_t, time_window_fn::params_t<std::decay_t<TsFn>, Duration, S, R>>
     {
-        return { { std::move(reducers.state)... },
-                 {
-                     { std::move(reducers.reducer)... },
-                 } };
+        check_positive(width, "tumbling_window: width must be positive");
+        return { { std::forward<TsFn>(ts_fn),
+                   width,
+                   width,
+                   allowed_lateness,
+                   std::move(reductor.state),
+                   std::move(reductor.reducer) } };
+    }
+};
+
+struct hopping_window_fn
+{
+    template <class TsFn, class Duration, class S, class R>
+    auto operator()(
+        TsFn&& ts_fn, Duration width, Duration hop, reductor_t<S, R> reductor, Duration allowed_lateness = {}) const
+        -> transducer_t<time_window_fn::reducer_t, time_window_fn::params_t<std::decay_t<TsFn>, Duration, S, R>>
+    {
+        check_positive(width, "hopping_window: width must be positive");
+        check_positive(hop, "hopping_window: hop must be positive");
+        return { { std::forward<TsFn>(ts_fn),
+                   width,
+                   hop,
+                   allowed_lateness,
+                   std::move(reductor.state),
+                   std::move(reductor.reducer) } };
     }
 };
 
@@ -1320,7 +6186,7 @@ struct for_each_fn
         template <class... Args>
         constexpr auto operator()(std::ptrdiff_t& state, Args&&... args) const -> bool
         {
-            std::invoke(m_func, std::forward<Args>(args)...);
+            detail::invoke(m_func, std::forward<Args>(args)...);
             ++state;
             return true;
         }
@@ -1343,7 +6209,7 @@ struct for_each_indexed_fn
         template <class... Args>
         constexpr auto operator()(std::ptrdiff_t& state, Args&&... args) const -> bool
         {
-            std::invoke(m_func, state++, std::forward<Args>(args)...);
+            detail::invoke(m_func, state++, std::forward<Args>(args)...);
             return true;
         }
     };
@@ -1355,6 +6221,69 @@ struct for_each_indexed_fn
     }
 };
 
+// for_each run on `workers` threads taking chunks of the range one by one. The result is the number of items.
+struct parallel_for_each_fn
+{
+    template <class Func>
+    auto operator()(Func&& func, std::size_t workers = 0) const -> parallel_reductor_t<
+        std::ptrdiff_t,
+        for_each_fn::reducer_t<std::decay_t<Func>>,
+        parallel_fn::fold_t<std::plus<>>>
+    {
+        return { for_each_fn{}(std::forward<Func>(func)),
+                 { std::plus<>{} },
+                 worker_count(workers),
+                 parallel_chunks_per_worker };
+    }
+};
+
+// Appends the per-worker (or per-chunk) containers to the target container.
+template <class Container>
+struct append_states_t
+{
+    std::reference_wrapper<Container> m_target;
+
+    auto operator()(std::vector<Container> states) const -> std::reference_wrapper<Container>
+    {
+        Container& target = m_target.get();
+        auto it = states.begin();
+        if (target.empty() && it != states.end())
+        {
+            target = std::move(*it++);
+        }
+        std::size_t size = 0;
+        for (auto state = it; state != states.end(); ++state)
+        {
+            size += std::size(*state);
+        }
+        reserve_more(target, size);
+        for (; it != states.end(); ++it)
+        {
+            target.insert(
+                std::end(target), std::make_move_iterator(std::begin(*it)), std::make_move_iterator(std::end(*it)));
+        }
+        return m_target;
+    }
+};
+
+// push_back run on `workers` threads taking chunks of the range one by one. The items are collected into a container
+// per worker (Stable = false) or per chunk (Stable = true, which keeps the input order), which are appended to the
+// target at the end.
+template <bool Stable>
+struct parallel_push_back_fn
+{
+    template <class Container>
+    auto operator()(Container& container, std::size_t workers = 0) const
+        -> parallel_reductor_t<Container, push_back_reducer_t, append_states_t<Container>>
+    {
+        return { { Container{}, push_back_reducer_t{} },
+                 { container },
+                 worker_count(workers),
+                 parallel_chunks_per_worker,
+                 Stable };
+    }
+};
+
 struct accumulate_fn
 {
     template <class Func>
@@ -1365,7 +6294,7 @@ struct accumulate_fn
         template <class State, class... Args>
         constexpr auto operator()(State& state, Args&&... args) const -> bool
         {
-            state = std::invoke(m_func, std::move(state), std::forward<Args>(args)...);
+            state = detail::invoke(m_func, std::move(state), std::forward<Args>(args)...);
             return true;
         }
     };
@@ -1383,9 +6312,14 @@ constexpr inline auto reduce = detail::reduce_fn{};
 constexpr inline auto out = detail::out_fn{};
 constexpr inline auto from = detail::from_fn{};
 constexpr inline auto chain = detail::chain_fn{};
+constexpr inline auto merge = detail::merge_fn{};
 constexpr inline auto range = detail::range_fn{};
 constexpr inline auto iota = detail::iota_fn{};
 constexpr inline auto read_lines = detail::read_lines_fn{};
+#ifdef TRX_HAS_POSIX
+constexpr inline auto read_blocks = detail::read_blocks_fn{};
+#endif  // TRX_HAS_POSIX
+constexpr inline auto cancellable = detail::cancellable_fn{};
 
 constexpr inline auto to_reducer = detail::to_reducer_fn{};
 
@@ -1411,11 +6345,21 @@ static constexpr inline auto drop_while = detail::drop_while_fn{};
 static constexpr inline auto drop_while_indexed = detail::drop_while_indexed_fn{};
 
 static constexpr inline auto take = detail::take_fn{};
+static constexpr inline auto take_for = detail::take_for_fn{};
+static constexpr inline auto cancel_on = detail::cancel_on_fn{};
 static constexpr inline auto drop = detail::drop_fn{};
 static constexpr inline auto stride = detail::stride_fn{};
 
 static constexpr inline auto join = detail::join_fn{}();
+static constexpr inline auto split_lines = detail::split_lines_fn{}();
 static constexpr inline auto intersperse = detail::intersperse_fn{};
+static constexpr inline auto distinct = detail::distinct_fn{};
+static constexpr inline auto sliding_window = detail::sliding_window_fn{};
+static constexpr inline auto hash_join = detail::hash_join_fn<detail::join_mode::inner>{};
+static constexpr inline auto left_hash_join = detail::hash_join_fn<detail::join_mode::left_outer>{};
+static constexpr inline auto semi_hash_join = detail::hash_join_fn<detail::join_mode::semi>{};
+static constexpr inline auto tumbling_window = detail::tumbling_window_fn{};
+static constexpr inline auto hopping_window = detail::hopping_window_fn{};
 
 static constexpr inline auto dev_null = reductor_t{ 0, detail::ignoring_reducer_t{} };
 
@@ -1425,16 +6369,53 @@ static constexpr inline auto none_of = detail::none_of_fn{};
 
 static constexpr inline auto partition = detail::partition_fn{};
 static constexpr inline auto fork = detail::fork_fn{};
+static constexpr inline auto group_by = detail::group_by_fn{};
+static constexpr inline auto parallel_group_by = detail::parallel_group_by_fn{};
+static constexpr inline auto parallel = detail::parallel_fn{};
+static constexpr inline auto parallel_transform = detail::parallel_transform_fn<true>{};
+static constexpr inline auto unordered_parallel_transform = detail::parallel_transform_fn<false>{};
+
+template <class T>
+static constexpr inline auto top_k = detail::top_k_fn<T, std::less<>>{};
+template <class T>
+static constexpr inline auto bottom_k = detail::top_k_fn<T, std::greater<>>{};
+
+template <class T>
+static constexpr inline auto chunk = detail::chunk_fn<T>{};
+
+template <class Key>
+static constexpr inline auto key_as = detail::key_as_fn<Key>{};
+
+template <class T>
+static constexpr inline auto shard = detail::shard_fn<T>{};
 
 static constexpr inline auto copy_to = detail::copy_to_fn{};
+static constexpr inline auto write_lines = detail::write_lines_fn{};
+
+template <class... Ts>
+static constexpr inline auto write_columns = detail::write_columns_fn<Ts...>{};
+
+#ifdef TRX_HAS_POSIX
+template <class... Ts>
+static constexpr inline auto read_columns = detail::read_columns_fn<Ts...>{};
+#endif  // TRX_HAS_POSIX
 static constexpr inline auto push_back = detail::push_back_fn{};
+static constexpr inline auto parallel_push_back = detail::parallel_push_back_fn<true>{};
+static constexpr inline auto unordered_parallel_push_back = detail::parallel_push_back_fn<false>{};
 static constexpr inline auto into = detail::into_fn{};
+static constexpr inline auto into_columns = detail::into_columns_fn{};
+static constexpr inline auto sorted_into = detail::sorted_into_fn{};
 
 static constexpr inline auto for_each = detail::for_each_fn{};
 static constexpr inline auto for_each_indexed = detail::for_each_indexed_fn{};
+static constexpr inline auto parallel_for_each = detail::parallel_for_each_fn{};
 
 static constexpr inline auto accumulate = detail::accumulate_fn{};
 
+static constexpr inline auto approx_distinct = detail::approx_distinct_fn{};
+static constexpr inline auto quantiles = detail::quantiles_fn{};
+static constexpr inline auto stats = detail::stats_fn{};
+
 static constexpr inline auto count = reductor_t{ std::size_t{ 0 },
                                                  [](std::size_t& state, auto&&...) -> bool
                                                  {
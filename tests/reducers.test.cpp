@@ -1,11 +1,29 @@
 #include <gmock/gmock.h>
 
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <list>
+#include <numeric>
 #include <sstream>
 #include <trx/trx.hpp>
 
 namespace
 {
 
+struct point_t
+{
+    int x;
+    int y;
+
+    friend auto operator<<(std::ostream& os, const point_t& p) -> std::ostream&
+    {
+        return os << "(" << p.x << " " << p.y << ")";
+    }
+};
+
 constexpr auto is_even = [](int value) { return value % 2 == 0; };
 
 constexpr inline struct str_fn
@@ -32,6 +50,52 @@ TEST(reducers, partition)
     EXPECT_THAT(odd, testing::ElementsAre(1, 3, 5, 7, 9));
 }
 
+TEST(reducers, shard)
+{
+    std::vector<int> input(1000);
+    std::iota(input.begin(), input.end(), 0);
+
+    const auto batches
+        = trx::transform([](trx::span<int> batch) { return batch.size(); }) |= trx::into(std::vector<std::size_t>{});
+    const auto result = input |= trx::shard<int>(8, [](int x) { return x; }, batches, 16);
+
+    ASSERT_EQ(result.states.size(), 8u);
+    EXPECT_EQ(std::accumulate(result.counts.begin(), result.counts.end(), std::size_t{ 0 }), 1000u);
+    for (std::size_t index = 0; index < 8; ++index)
+    {
+        const auto& sizes = result.states[index];
+        EXPECT_EQ(std::accumulate(sizes.begin(), sizes.end(), std::size_t{ 0 }), result.counts[index]);
+        EXPECT_TRUE(std::all_of(sizes.begin(), sizes.end() - 1, [](std::size_t size) { return size == 16; }));
+        EXPECT_GT(result.counts[index], 80u);
+    }
+
+    const std::vector<std::string> words = { "alpha", "beta", "gamma", "delta", "alpha", "beta", "alpha" };
+    const auto collect = trx::join |= trx::into(std::vector<std::string>{});
+    const auto by_word = words |= trx::shard<std::string>(4, [](const std::string& w) { return w; }, collect, 2, 42);
+    for (const auto& shard : by_word.states)
+    {
+        for (const std::string& word : shard)
+        {
+            EXPECT_EQ(std::count(shard.begin(), shard.end(), word), std::count(words.begin(), words.end(), word));
+        }
+    }
+    const auto same_seed = words |= trx::shard<std::string>(4, [](const std::string& w) { return w; }, collect, 2, 42);
+    EXPECT_EQ(same_seed.states, by_word.states);
+    const auto reseeded = words |= trx::shard<std::string>(4, [](const std::string& w) { return w; }, collect, 2, 7);
+    EXPECT_NE(reseeded.states, by_word.states);
+    for (const auto& shard : reseeded.states)
+    {
+        for (const std::string& word : shard)
+        {
+            EXPECT_EQ(std::count(shard.begin(), shard.end(), word), std::count(words.begin(), words.end(), word));
+        }
+    }
+
+    const auto first = input |= trx::shard<int>(2, [](int x) { return x % 10; }, trx::take(1) |= batches, 4);
+    EXPECT_THAT(first.states, testing::Each(testing::ElementsAre(4u)));
+    EXPECT_LT(std::accumulate(first.counts.begin(), first.counts.end(), std::size_t{ 0 }), 1000u);
+}
+
 TEST(reducers, fork)
 {
     std::vector<int> values;
@@ -52,6 +116,379 @@ TEST(reducers, fork)
     EXPECT_THAT(d, 2);
 }
 
+TEST(reducers, group_by)
+{
+    struct event_t
+    {
+        int user;
+        int value;
+    };
+
+    const auto xform = trx::group_by(
+        &event_t::user, trx::transform(&event_t::value) |= trx::take(2) |= trx::into(std::vector<int>{}));
+    std::vector<event_t> input;
+    for (int i = 0; i < 1000; ++i)
+    {
+        input.push_back(event_t{ i % 100, i });
+    }
+    const auto result = input |= xform;
+
+    EXPECT_THAT(result.size(), 100u);
+    EXPECT_THAT(result.find(0)->second, testing::ElementsAre(0, 100));
+    EXPECT_THAT(result.find(42)->second, testing::ElementsAre(42, 142));
+    EXPECT_THAT(result.find(99)->second, testing::ElementsAre(99, 199));
+    EXPECT_THAT(result.find(100), result.end());
+    EXPECT_THAT(trx::reduce(xform, std::vector<event_t>{}), testing::IsEmpty());
+}
+
+TEST(reducers, group_by_generic_key)
+{
+    const std::vector<std::string> input = { "apple", "avocado", "banana", "blueberry", "cherry" };
+    const auto first_letter = [](const auto& s) { return s[0]; };
+
+    const auto result = input |= trx::group_by(trx::key_as<char>(first_letter), trx::count);
+    EXPECT_THAT(result.size(), 3u);
+    EXPECT_THAT(result.find('a')->second, 2u);
+    EXPECT_THAT(result.find('c')->second, 1u);
+
+    const auto parallel = input |= trx::parallel_group_by(trx::key_as<char>(first_letter), trx::count, std::plus<>{}, 2);
+    EXPECT_THAT(parallel.find('b')->second, 2u);
+}
+
+TEST(reducers, parallel_group_by)
+{
+    std::vector<int> input(100000);
+    std::iota(input.begin(), input.end(), 0);
+
+    const auto combine = [](const auto& lhs, const auto& rhs)
+    { return std::make_tuple(std::get<0>(lhs) + std::get<0>(rhs), std::get<1>(lhs) + std::get<1>(rhs)); };
+    const auto result = input |= trx::filter(is_even)
+        |= trx::parallel_group_by([](int x) { return x % 1000; }, trx::fork(trx::count, trx::sum(0L)), combine);
+
+    EXPECT_THAT(result.size(), 500u);
+    EXPECT_THAT(result.find(1), result.end());
+    for (int key = 0; key < 1000; key += 2)
+    {
+        const auto it = result.find(key);
+        ASSERT_NE(it, result.end());
+        EXPECT_THAT(it->second, testing::Eq(std::make_tuple(100u, 100L * key + 1000L * (99 * 100 / 2))));
+    }
+    EXPECT_THAT(
+        std::vector<int>{} |= trx::parallel_group_by([](int x) { return x; }, trx::count, std::plus<>{}),
+        testing::IsEmpty());
+
+    const auto first
+        = input |= trx::take(10) |= trx::parallel_group_by([](int x) { return x % 3; }, trx::count, std::plus<>{}, 4);
+    EXPECT_THAT(first.find(0)->second + first.find(1)->second + first.find(2)->second, 10u);
+    const auto distinct = input |= trx::transform([](int x) { return x % 7; }) |= trx::distinct([](int x) { return x; })
+        |= trx::parallel_group_by([](int x) { return x; }, trx::count, std::plus<>{}, 4);
+    EXPECT_THAT(distinct.size(), 7u);
+    EXPECT_THAT(distinct.find(3)->second, 1u);
+}
+
+TEST(reducers, top_k)
+{
+    struct request_t
+    {
+        int id;
+        double latency;
+    };
+
+    std::vector<request_t> input;
+    for (int i = 0; i < 10000; ++i)
+    {
+        input.push_back(request_t{ i, static_cast<double>((i * 7919) % 10007) });
+    }
+    const auto id = [](const request_t& r) { return r.id; };
+
+    const auto slowest = input |= trx::top_k<request_t>(4, &request_t::latency);
+    EXPECT_THAT(slowest.size(), 4u);
+    EXPECT_THAT(slowest.threshold().latency, 10003.0);
+    EXPECT_THAT(
+        slowest.sorted() |= trx::transform(id) |= trx::into(std::vector<int>{}),
+        testing::ElementsAre(1040, 2080, 3120, 4160));
+
+    const auto fastest = input |= trx::parallel(trx::bottom_k<request_t>(3, &request_t::latency), 8);
+    EXPECT_THAT(
+        fastest.sorted() |= trx::transform(id) |= trx::into(std::vector<int>{}), testing::ElementsAre(0, 8967, 7927));
+
+    const auto tail = input |= trx::drop(9997) |= trx::parallel(trx::top_k<request_t>(5, &request_t::latency), 8);
+    EXPECT_THAT(
+        tail.sorted() |= trx::transform(id) |= trx::into(std::vector<int>{}), testing::ElementsAre(9998, 9999, 9997));
+    EXPECT_EQ(input |= trx::take(10) |= trx::parallel(trx::count, std::plus<>{}, 4), 10u);
+    EXPECT_EQ(
+        input |= trx::filter_indexed([](std::ptrdiff_t index, const request_t&) { return index < 100; })
+            |= trx::parallel(trx::count, std::plus<>{}, 4),
+        100u);
+
+    EXPECT_THAT(std::vector<int>{} |= trx::top_k<int>(3), testing::IsEmpty());
+    EXPECT_THAT((std::vector<int>{ 1, 2, 3 } |= trx::top_k<int>(0)), testing::IsEmpty());
+}
+
+TEST(reducers, sorted_into)
+{
+    std::vector<std::int64_t> timestamps;
+    std::vector<std::string> words;
+    for (std::int64_t i = 0; i < 5000; ++i)
+    {
+        timestamps.push_back(1700000000000 + (i * 7919) % 5003 - 2500 * (i % 3));
+        words.push_back(str(static_cast<char>('a' + i % 7), "prefix", (i * 31) % 977));
+    }
+
+    auto expected_timestamps = timestamps;
+    std::sort(expected_timestamps.begin(), expected_timestamps.end());
+    EXPECT_THAT(timestamps |= trx::sorted_into(std::vector<std::int64_t>{}), testing::ContainerEq(expected_timestamps));
+
+    auto expected_words = words;
+    std::sort(expected_words.begin(), expected_words.end());
+    EXPECT_THAT(words |= trx::sorted_into(std::vector<std::string>{}), testing::ContainerEq(expected_words));
+
+    const auto sorted = trx::range(0, 1000) |= trx::transform([](int x) { return x % 400; })
+        |= trx::sorted_into(std::vector<int>{}, [](int x) { return -(x / 10); });
+    EXPECT_THAT(sorted, testing::SizeIs(1000));
+    EXPECT_THAT(
+        std::vector<int>(sorted.begin(), sorted.begin() + 12),
+        testing::ElementsAre(390, 391, 392, 393, 394, 395, 396, 397, 398, 399, 390, 391));
+
+    // `const char*` keys are compared by contents both below and above the radix sort threshold, also when the
+    // 8 character prefixes are equal.
+    for (const std::size_t count : { std::size_t{ 100 }, std::size_t{ 1000 } })
+    {
+        std::vector<std::string> storage;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            storage.push_back(str("prefix__", (i * 7919) % count));
+        }
+        std::vector<const char*> pointers;
+        for (const std::string& s : storage)
+        {
+            pointers.push_back(s.c_str());
+        }
+        std::reverse(pointers.begin(), pointers.end());
+        const auto sorted_pointers = pointers |= trx::sorted_into(std::vector<const char*>{});
+        auto expected = storage;
+        std::sort(expected.begin(), expected.end());
+        EXPECT_THAT(
+            std::vector<std::string>(sorted_pointers.begin(), sorted_pointers.end()), testing::ContainerEq(expected));
+    }
+}
+
+TEST(reducers, approx_distinct)
+{
+    std::vector<std::int64_t> input(400000);
+    std::iota(input.begin(), input.end(), 0);
+    for (auto& value : input)
+    {
+        value %= 100000;
+    }
+
+    const auto sketch = input |= trx::approx_distinct();
+    EXPECT_THAT(sketch.registers().size(), 16384u);
+    EXPECT_THAT(sketch.estimate(), testing::DoubleNear(100000.0, 3000.0));
+
+    const auto merged = input |= trx::parallel(trx::approx_distinct(), 4);
+    EXPECT_THAT(merged.registers(), testing::ContainerEq(sketch.registers()));
+
+    EXPECT_THAT((std::vector<int>{} |= trx::approx_distinct()).estimate(), 0.0);
+
+    trx::hyperloglog coarse{ 10 };
+    EXPECT_THROW(coarse.merge(sketch), std::invalid_argument);
+    EXPECT_THAT(trx::hyperloglog{ 40 }.precision(), 18u);
+}
+
+TEST(reducers, quantiles)
+{
+    const int n = 200000;
+    std::vector<int> input(n);
+    for (int i = 0; i < n; ++i)
+    {
+        input[i] = static_cast<int>((static_cast<std::int64_t>(i) * 7919) % n);
+    }
+
+    const auto sketch = input |= trx::quantiles(0.01);
+    EXPECT_THAT(sketch.count(), static_cast<std::size_t>(n));
+    EXPECT_THAT(sketch.size(), testing::Lt(1000u));
+    EXPECT_THAT(sketch.quantile(0.5), testing::DoubleNear(0.5 * n, 0.01 * n));
+    EXPECT_THAT(sketch.quantile(0.99), testing::DoubleNear(0.99 * n, 0.01 * n));
+    EXPECT_THAT(sketch.quantile(0.999), testing::DoubleNear(0.999 * n, 0.01 * n));
+    EXPECT_THAT(sketch.quantile(0.0), testing::DoubleNear(0.0, 0.01 * n));
+    EXPECT_THAT(sketch.quantile(1.0), testing::DoubleNear(n, 0.01 * n));
+
+    const auto merged = input |= trx::parallel(trx::quantiles(0.01), 4);
+    EXPECT_THAT(merged.count(), static_cast<std::size_t>(n));
+    EXPECT_THAT(merged.quantile(0.5), testing::DoubleNear(0.5 * n, 0.01 * n));
+    EXPECT_THAT(merged.quantile(0.99), testing::DoubleNear(0.99 * n, 0.01 * n));
+}
+
+TEST(reducers, stats)
+{
+    std::vector<double> input;
+    for (int i = 0; i < 10000; ++i)
+    {
+        input.push_back(1e9 + (i % 100) * 0.5);
+    }
+
+    const auto result = input |= trx::stats();
+    EXPECT_THAT(result.count(), 10000u);
+    EXPECT_THAT(result.mean(), testing::DoubleNear(1e9 + 24.75, 1e-4));
+    EXPECT_THAT(result.variance(), testing::DoubleNear(208.3125, 1e-6));
+    EXPECT_THAT(result.min(), 1e9);
+    EXPECT_THAT(result.max(), 1e9 + 49.5);
+
+    const auto scalar = std::list<double>(input.begin(), input.end()) |= trx::stats();
+    EXPECT_THAT(scalar.count(), result.count());
+    EXPECT_THAT(scalar.mean(), testing::DoubleNear(result.mean(), 1e-4));
+    EXPECT_THAT(scalar.variance(), testing::DoubleNear(result.variance(), 1e-6));
+
+    const auto blocks = std::vector<std::vector<double>>{ input, {}, { 1e9 + 24.75 } } |= trx::stats();
+    EXPECT_THAT(blocks.count(), 10001u);
+    EXPECT_THAT(blocks.mean(), testing::DoubleNear(1e9 + 24.75, 1e-4));
+    EXPECT_THAT(blocks.variance(), testing::DoubleNear(208.3125 * 10000 / 10001, 1e-6));
+
+    const auto merged = input |= trx::parallel(trx::stats(), 4);
+    EXPECT_THAT(merged.count(), 10000u);
+    EXPECT_THAT(merged.mean(), testing::DoubleNear(result.mean(), 1e-4));
+    EXPECT_THAT(merged.variance(), testing::DoubleNear(result.variance(), 1e-6));
+
+    EXPECT_THAT((std::vector<int>{} |= trx::stats()).count(), 0u);
+}
+
+TEST(reducers, write_lines)
+{
+    std::ostringstream out;
+    const auto writer = trx::write_lines(out, "|", 16);
+    const auto result = trx::from(std::vector<std::string>{ "a", "b", "c" }, std::vector<char>{ 'x', 'y', 'z' })
+        |= trx::transform([](const std::string& s, char c) { return std::tuple{ s, c, true, -1.5, point_t{ 1, 2 } }; })
+        |= trx::unpack |= writer;
+    EXPECT_THAT(out.str(), "a|x|true|-1.5|(1 2)\nb|y|true|-1.5|(1 2)\nc|z|true|-1.5|(1 2)\n");
+    EXPECT_THAT(result.count(), 3u);
+
+#ifdef TRX_HAS_POSIX
+    std::FILE* file = std::tmpfile();
+    ASSERT_THAT(file, testing::NotNull());
+    std::vector<int> input(10000);
+    std::iota(input.begin(), input.end(), -5000);
+    EXPECT_THAT((input |= trx::write_lines(fileno(file), " ", 4096)).count(), 10000u);
+
+    std::rewind(file);
+    std::string content;
+    for (int ch = std::fgetc(file); ch != EOF; ch = std::fgetc(file))
+    {
+        content += static_cast<char>(ch);
+    }
+    std::fclose(file);
+    std::istringstream lines(content);
+    std::vector<int> read_back;
+    for (int value = 0; lines >> value;)
+    {
+        read_back.push_back(value);
+    }
+    EXPECT_THAT(read_back, testing::ElementsAreArray(input));
+#endif  // TRX_HAS_POSIX
+}
+
+#ifdef TRX_HAS_POSIX
+
+TEST(reducers, columnar_file)
+{
+    const std::string path = (std::filesystem::temp_directory_path() / "trx_reducers_columnar_file.trxc").string();
+    using row_t = std::tuple<std::uint8_t, std::int16_t, float, std::uint64_t>;
+    std::vector<row_t> rows;
+    for (int i = 0; i < 1000; ++i)
+    {
+        rows.emplace_back(i % 256, static_cast<std::int16_t>(i - 500), i * 0.25f, std::uint64_t{ 1 } << (i % 64));
+    }
+    {
+        std::ofstream out(path, std::ios::binary);
+        const auto writer = rows |= trx::write_columns<std::uint8_t, std::int16_t, float, std::uint64_t>(out, 64);
+        EXPECT_THAT(writer.count(), 1000u);
+    }
+
+    const auto read = trx::read_columns<std::uint8_t, std::int16_t, float, std::uint64_t>(path, { 0, 1, 2, 3 })
+        |= trx::transform([](auto... values) { return row_t{ values... }; }) |= trx::into(std::vector<row_t>{});
+    EXPECT_THAT(read, testing::ElementsAreArray(rows));
+
+    const auto selected = trx::read_columns<float>(path, { 2 }, trx::column_range<std::int16_t>{ 1, 100, 139 })
+        |= trx::into(std::vector<float>{});
+    ASSERT_THAT(selected.size(), 40u);
+    EXPECT_THAT(selected.front(), 150.0f);
+    EXPECT_THAT(selected.back(), 159.75f);
+
+    EXPECT_THAT((trx::read_columns<std::int16_t>(path, { 1 }) |= trx::take(3) |= trx::into(std::vector<std::int16_t>{})),
+                testing::ElementsAre(-500, -499, -498));
+    EXPECT_THROW(trx::read_columns<double>(path, { 2 }) |= trx::count, std::runtime_error);
+    EXPECT_THROW(trx::read_columns<float>(path, { 7 }) |= trx::count, std::runtime_error);
+    EXPECT_THROW(trx::read_columns<float>(path + ".missing", { 2 }) |= trx::count, std::system_error);
+    std::filesystem::remove(path);
+
+    {
+        std::ofstream out(path, std::ios::binary);
+        std::vector<std::tuple<double>>{} |= trx::write_columns<double>(out);
+    }
+    EXPECT_THAT(trx::read_columns<double>(path, { 0 }) |= trx::count, 0u);
+    std::filesystem::remove(path);
+
+    std::ofstream closed;
+    EXPECT_THROW(std::vector<double>(100, 1.0) |= trx::write_columns<double>(closed, 64), std::ios_base::failure);
+    EXPECT_THROW(std::vector<double>(10, 1.0) |= trx::write_columns<double>(closed, 64), std::ios_base::failure);
+    if constexpr (sizeof(std::size_t) > sizeof(std::uint32_t))
+    {
+        EXPECT_THROW(trx::write_columns<double>(closed, std::size_t{ 1 } << 32), std::invalid_argument);
+    }
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    {
+        std::ofstream out(path, std::ios::binary);
+        std::vector<double>{ nan, 1.0, 2.0, nan, nan, nan, nan, nan, 10.0, nan, 11.0, 12.0 }
+            |= trx::write_columns<double>(out, 4);
+    }
+    EXPECT_THAT((trx::read_columns<double>(path, { 0 }, trx::column_range<double>{ 0, 1.5, 10.5 })
+                 |= trx::into(std::vector<double>{})),
+                testing::ElementsAre(2.0, 10.0));
+    EXPECT_THAT(trx::read_columns<double>(path, { 0 }) |= trx::count, 12u);
+
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(20);
+        file.put(static_cast<char>(0xff));
+    }
+    EXPECT_THROW(trx::read_columns<double>(path, { 0 }) |= trx::count, std::runtime_error);
+    std::filesystem::remove(path);
+}
+
+#endif  // TRX_HAS_POSIX
+
+TEST(reducers, into_columns)
+{
+    std::vector<int> input(1000);
+    std::iota(input.begin(), input.end(), 0);
+
+    const auto [values, squares, names] = input
+        |= trx::transform([](int x) { return std::tuple{ x, x * x, std::to_string(x) }; })
+        |= trx::into_columns(std::vector<int>{}, std::vector<long>{}, std::vector<std::string>{});
+    EXPECT_THAT(values, testing::ElementsAreArray(input));
+    EXPECT_THAT(squares[999], 998001);
+    EXPECT_THAT(names[42], "42");
+    EXPECT_THAT(values.capacity(), 1000u);
+    EXPECT_THAT(names.capacity(), 1000u);
+
+    std::vector<int> evens = { -2 };
+    std::vector<int> odds;
+    std::tie(std::ignore, std::ignore) = trx::from(input, trx::iota(1))
+        |= trx::filter([](int x, int) { return x < 4; })
+        |= trx::transform([](int x, int y) { return std::pair{ 2 * x, 2 * y - 1 }; })
+        |= trx::into_columns(std::ref(evens), &odds);
+    EXPECT_THAT(evens, testing::ElementsAre(-2, 0, 2, 4, 6));
+    EXPECT_THAT(odds, testing::ElementsAre(1, 3, 5, 7));
+
+    const auto zipped = trx::reduce(trx::into_columns(std::vector<int>{}, std::vector<int>{}), input, std::vector<int>(10));
+    EXPECT_THAT(std::get<0>(zipped).capacity(), 10u);
+    const auto chained = trx::chain(input, input)  //
+        |= trx::transform([](int x) { return -x; })  //
+        |= trx::into(std::vector<int>{});
+    EXPECT_THAT(chained.capacity(), 2000u);
+}
+
 TEST(reducers, output_iterator)
 {
     const std::vector<int> input = { 1, 2, 3, 4, 5 };
@@ -118,6 +555,33 @@ TEST(reducers, sum)
     EXPECT_THAT(trx::from(std::vector<int>{ 1, 2, 3, 4, 5 }) |= trx::sum(0), 15);
 }
 
+TEST(reducers, direct_call)
+{
+    auto reductor = trx::transform([](int x) { return x * 10; }) |= trx::into(std::vector<int>{});
+    EXPECT_TRUE(reductor(1));
+    EXPECT_TRUE(reductor(2));
+    EXPECT_THAT(reductor.get(), testing::ElementsAre(10, 20));
+
+    auto taking = trx::take(1) |= trx::into(std::vector<int>{});
+    EXPECT_TRUE(taking(1));
+    EXPECT_FALSE(taking(2));
+    EXPECT_THAT(taking.get(), testing::ElementsAre(1));
+
+    const auto batches
+        = trx::transform([](trx::span<int> batch) { return batch.size(); }) |= trx::into(std::vector<std::size_t>{});
+    auto sharding = trx::shard<int>(2, [](int x) { return x; }, batches, 4);
+    for (int x = 0; x < 100; ++x)
+    {
+        sharding(x);
+    }
+    std::size_t delivered = 0;
+    for (const auto& sizes : sharding.get().states)
+    {
+        delivered = std::accumulate(sizes.begin(), sizes.end(), delivered);
+    }
+    EXPECT_GE(delivered, 92u);
+}
+
 TEST(reducers, generator)
 {
     const auto result = trx::generator_t<int>(
@@ -216,6 +680,51 @@ TEST(reducers, for_each_indexed)
     EXPECT_THAT(result, testing::ElementsAre(2, 104, 206, 308, 410));
 }
 
+TEST(reducers, parallel_for_each)
+{
+    std::vector<int> input(1000);
+    std::iota(input.begin(), input.end(), 0);
+    std::vector<std::atomic<int>> visits(input.size());
+
+    const auto count = input |= trx::parallel_for_each([&visits](int x) { ++visits[x]; }, 4);
+
+    EXPECT_EQ(count, 1000);
+    EXPECT_TRUE(std::all_of(visits.begin(), visits.end(), [](const std::atomic<int>& v) { return v == 1; }));
+}
+
+TEST(reducers, parallel_push_back)
+{
+    std::vector<int> input(1000);
+    std::iota(input.begin(), input.end(), 0);
+
+    std::vector<int> result = { -1 };
+    input |= trx::transform([](int x) { return x * 2; }) |= trx::parallel_push_back(result, 4);
+    ASSERT_EQ(result.size(), 1001u);
+    EXPECT_EQ(result.front(), -1);
+    EXPECT_TRUE(std::equal(input.begin(), input.end(), result.begin() + 1, [](int x, int y) { return y == x * 2; }));
+
+    std::list<int> unordered;
+    input |= trx::unordered_parallel_push_back(unordered, 3);
+    std::vector<int> sorted(unordered.begin(), unordered.end());
+    std::sort(sorted.begin(), sorted.end());
+    EXPECT_EQ(sorted, input);
+
+    std::vector<int> few;
+    std::vector<int>{ 1, 2, 3 } |= trx::parallel_push_back(few, 8);
+    EXPECT_THAT(few, testing::ElementsAre(1, 2, 3));
+
+    std::vector<int> window;
+    input |= trx::drop(5) |= trx::take(20) |= trx::parallel_push_back(window, 4);
+    EXPECT_THAT(window, testing::ElementsAreArray(input.begin() + 5, input.begin() + 25));
+
+    trx::cancellation_source source;
+    std::vector<int> prefix;
+    input |= trx::cancel_on(source.token(), 1) |= trx::inspect([&source](int x) { x == 500 ? source.cancel() : void(); })
+        |= trx::parallel_push_back(prefix, 4);
+    EXPECT_LE(prefix.size(), 501u);
+    EXPECT_TRUE(std::equal(prefix.begin(), prefix.end(), input.begin()));
+}
+
 TEST(reducers, accumulate)
 {
     std::vector<int> input = { 1, 2, 3, 4, 5 };
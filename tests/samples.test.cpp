@@ -1,6 +1,9 @@
 #include <gmock/gmock.h>
 
+#include <filesystem>
+#include <fstream>
 #include <optional>
+#include <sstream>
 #include <string>
 #include <trx/trx.hpp>
 #include <vector>
@@ -191,6 +194,19 @@ TEST(samples, join)
     EXPECT_THAT(result, testing::ElementsAre(1, 2, 3, 4, 5, 6));
 }
 
+TEST(samples, chunk)
+{
+    std::vector<int> input = { 1, 2, 3, 4, 5, 6, 7 };
+    std::vector<std::vector<int>> result = input                                                                //
+        |= trx::chunk<int>(3)                                                                               //
+        |= trx::transform([](trx::span<int> batch) { return std::vector<int>(batch.begin(), batch.end()); })  //
+        |= trx::into(std::vector<std::vector<int>>{});
+
+    EXPECT_THAT(
+        result,
+        testing::ElementsAre(testing::ElementsAre(1, 2, 3), testing::ElementsAre(4, 5, 6), testing::ElementsAre(7)));
+}
+
 TEST(samples, intersperse)
 {
     std::string input = "ABCD";
@@ -201,6 +217,89 @@ TEST(samples, intersperse)
     EXPECT_THAT(result, testing::Eq("A,B,C,D"));
 }
 
+TEST(samples, distinct)
+{
+    std::vector<int> input = { 3, 1, 3, 2, 1, 4 };
+    std::vector<int> result = input                  //
+        |= trx::distinct([](int x) { return x; })  //
+        |= trx::into(std::vector<int>{});
+    std::vector<int> approximate = input                          //
+        |= trx::distinct([](int x) { return x; }, 1000, 0.001)  //
+        |= trx::into(std::vector<int>{});
+
+    EXPECT_THAT(result, testing::ElementsAre(3, 1, 2, 4));
+    EXPECT_THAT(approximate, testing::ElementsAre(3, 1, 2, 4));
+}
+
+TEST(samples, hash_join)
+{
+    struct customer
+    {
+        int id;
+        std::string name;
+    };
+    using order_t = std::pair<int, int>;
+    std::vector<customer> customers = { { 1, "Alice" }, { 2, "Bob" } };
+    std::vector<order_t> orders = { { 1, 100 }, { 3, 200 }, { 2, 300 } };
+    const auto customer_id = [](const order_t& o) { return o.first; };
+
+    std::vector<std::string> result = orders                                                                             //
+        |= trx::hash_join(customers, &customer::id, customer_id)                                                    //
+        |= trx::transform([](const order_t& o, const customer& c) { return c.name + ":" + std::to_string(o.second); })  //
+        |= trx::into(std::vector<std::string>{});
+    std::vector<std::string> all = orders                                                                 //
+        |= trx::left_hash_join(customers, &customer::id, customer_id)                                //
+        |= trx::transform([](const order_t&, const customer* c) { return c ? c->name : "?"; })  //
+        |= trx::into(std::vector<std::string>{});
+
+    EXPECT_THAT(result, testing::ElementsAre("Alice:100", "Bob:300"));
+    EXPECT_THAT(all, testing::ElementsAre("Alice", "?", "Bob"));
+}
+
+TEST(samples, sliding_window)
+{
+    std::vector<int> input = { 1, 2, 3, 4, 5, 6 };
+    std::vector<int> sums = input                                  //
+        |= trx::sliding_window(3, trx::sum(0), std::plus<>{})  //
+        |= trx::into(std::vector<int>{});
+    std::vector<double> maxima = input                                                 //
+        |= trx::sliding_window(2, trx::stats())                                     //
+        |= trx::transform([](const trx::running_stats& s) { return s.max(); })  //
+        |= trx::into(std::vector<double>{});
+
+    EXPECT_THAT(sums, testing::ElementsAre(1, 3, 6, 9, 12, 15));
+    EXPECT_THAT(maxima, testing::ElementsAre(1, 2, 3, 4, 5, 6));
+}
+
+TEST(samples, tumbling_window)
+{
+    using event_t = std::pair<int, int>;
+    std::vector<event_t> input = { { 1, 10 }, { 4, 20 }, { 12, 30 }, { 7, 40 }, { 25, 50 }, { 31, 60 } };
+    const auto ts = [](const event_t& e) { return e.first; };
+    const auto to_pair = [](const trx::time_window<int, int>& w) { return std::pair{ w.start, w.state }; };
+
+    std::vector<event_t> result = input                                                                //
+        |= trx::tumbling_window(ts, 10, trx::project(&event_t::second) |= trx::sum(0))            //
+        |= trx::transform(to_pair)                                                                 //
+        |= trx::into(std::vector<event_t>{});
+    std::vector<event_t> hopping = input                                                               //
+        |= trx::hopping_window(ts, 10, 5, trx::project(&event_t::second) |= trx::sum(0), 5)       //
+        |= trx::transform(to_pair)                                                                 //
+        |= trx::into(std::vector<event_t>{});
+
+    EXPECT_THAT(result, testing::ElementsAre(event_t{ 0, 30 }, event_t{ 10, 30 }, event_t{ 20, 50 }, event_t{ 30, 60 }));
+    EXPECT_THAT(
+        hopping,
+        testing::ElementsAre(
+            event_t{ -5, 30 },
+            event_t{ 0, 70 },
+            event_t{ 5, 70 },
+            event_t{ 10, 30 },
+            event_t{ 20, 50 },
+            event_t{ 25, 110 },
+            event_t{ 30, 60 }));
+}
+
 TEST(samples, all_of)
 {
     std::vector<int> input = { 2, 4, 6, 8 };
@@ -234,6 +333,22 @@ TEST(samples, dev_null)
     EXPECT_THAT(ss.str(), testing::Eq("1 2 3 4 5 "));
 }
 
+TEST(samples, into_columns)
+{
+    struct S
+    {
+        int a;
+        double b;
+    };
+    std::vector<S> input = { { 1, 0.5 }, { 2, 1.5 }, { 3, 2.5 } };
+    auto [a, b] = input                      //
+        |= trx::project(&S::a, &S::b)  //
+        |= trx::into_columns(std::vector<int>{}, std::vector<double>{});
+
+    EXPECT_THAT(a, testing::ElementsAre(1, 2, 3));
+    EXPECT_THAT(b, testing::ElementsAre(0.5, 1.5, 2.5));
+}
+
 TEST(samples, partition)
 {
     std::vector<int> input = { 1, 2, 3, 4, 5 };
@@ -259,6 +374,42 @@ TEST(samples, fork)
     EXPECT_EQ(second, 5u);
 }
 
+TEST(samples, group_by)
+{
+    std::vector<std::string> input = { "apple", "avocado", "banana", "blueberry", "cherry" };
+    auto result = input
+        |= trx::group_by(
+            [](const std::string& s) { return s[0]; },
+            trx::fork(
+                trx::count,  //
+                trx::transform([](const std::string& s) { return s.size(); }) |= trx::sum(std::size_t{ 0 })));
+
+    EXPECT_THAT(
+        result,
+        testing::UnorderedElementsAre(
+            testing::Pair('a', std::make_tuple(2u, 12u)),
+            testing::Pair('b', std::make_tuple(2u, 15u)),
+            testing::Pair('c', std::make_tuple(1u, 6u))));
+}
+
+TEST(samples, parallel_group_by)
+{
+    std::vector<int> input = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+    auto result = input |= trx::parallel_group_by([](int x) { return x % 3; }, trx::sum(0), std::plus<>{}, 4);
+
+    EXPECT_THAT(result, testing::UnorderedElementsAre(testing::Pair(0, 18), testing::Pair(1, 22), testing::Pair(2, 15)));
+}
+
+TEST(samples, top_k)
+{
+    std::vector<int> input = { 5, 1, 9, 3, 7, 2, 8 };
+    std::vector<int> top = (input |= trx::top_k<int>(3)).sorted();
+    std::vector<int> bottom = (input |= trx::bottom_k<int>(2)).sorted();
+
+    EXPECT_THAT(top, testing::ElementsAre(9, 8, 7));
+    EXPECT_THAT(bottom, testing::ElementsAre(1, 2));
+}
+
 TEST(samples, copy_to)
 {
     std::vector<int> input = { 1, 2, 3, 4, 5 };
@@ -268,6 +419,45 @@ TEST(samples, copy_to)
     EXPECT_THAT(dest, testing::ElementsAre(1, 2, 3, 4, 5));
 }
 
+TEST(samples, write_lines)
+{
+    std::vector<int> ids = { 1, 2, 3 };
+    std::vector<double> values = { 0.5, 1.25, 2 };
+    std::ostringstream out;
+    std::size_t lines = (trx::from(ids, values) |= trx::write_lines(out, ",")).count();
+
+    EXPECT_EQ(out.str(), "1,0.5\n2,1.25\n3,2\n");
+    EXPECT_EQ(lines, 3u);
+}
+
+#ifdef TRX_HAS_POSIX
+
+TEST(samples, write_columns)
+{
+    const std::string path = (std::filesystem::temp_directory_path() / "trx_samples_write_columns.trxc").string();
+    std::vector<std::int32_t> ids = { 1, 2, 3, 4, 5, 6 };
+    std::vector<double> prices = { 9.5, 3.0, 7.25, 1.0, 4.5, 8.0 };
+    std::vector<std::int64_t> days = { 10, 10, 11, 12, 12, 13 };
+    {
+        std::ofstream out(path, std::ios::binary);
+        trx::from(ids, prices, days) |= trx::write_columns<std::int32_t, double, std::int64_t>(out, 2);
+    }
+    std::vector<std::pair<std::int64_t, double>> result = trx::read_columns<std::int64_t, double>(
+                                                              path, { 2, 1 }, trx::column_range<std::int64_t>{ 2, 11, 12 })
+        |= trx::transform([](std::int64_t day, double price) { return std::pair{ day, price }; })
+        |= trx::into(std::vector<std::pair<std::int64_t, double>>{});
+    std::filesystem::remove(path);
+
+    EXPECT_THAT(
+        result,
+        testing::ElementsAre(
+            std::pair<std::int64_t, double>{ 11, 7.25 },
+            std::pair<std::int64_t, double>{ 12, 1.0 },
+            std::pair<std::int64_t, double>{ 12, 4.5 }));
+}
+
+#endif  // TRX_HAS_POSIX
+
 TEST(samples, push_back)
 {
     std::vector<int> input = { 1, 2, 3 };
@@ -285,6 +475,50 @@ TEST(samples, into)
     EXPECT_THAT(result, testing::ElementsAre(1, 2, 3, 4, 5));
 }
 
+TEST(samples, sorted_into)
+{
+    std::vector<std::string> input = { "pear", "apple", "fig", "banana" };
+    std::vector<std::string> result
+        = input |= trx::sorted_into(std::vector<std::string>{}, [](const std::string& s) { return s.size(); });
+
+    EXPECT_THAT(result, testing::ElementsAre("fig", "pear", "apple", "banana"));
+}
+
+TEST(samples, approx_distinct)
+{
+    std::vector<int> input = { 1, 2, 3, 2, 1, 4, 5, 4 };
+    double result = (input |= trx::approx_distinct(10)).estimate();
+
+    EXPECT_THAT(result, testing::DoubleNear(5.0, 0.1));
+}
+
+TEST(samples, quantiles)
+{
+    std::vector<double> latencies;
+    for (int i = 1; i <= 1000; ++i)
+    {
+        latencies.push_back(i);
+    }
+    auto sketch = latencies |= trx::quantiles(0.01);
+    double p50 = sketch.quantile(0.5);
+    double p99 = sketch.quantile(0.99);
+
+    EXPECT_THAT(p50, testing::DoubleNear(500.0, 20.0));
+    EXPECT_THAT(p99, testing::DoubleNear(990.0, 20.0));
+}
+
+TEST(samples, stats)
+{
+    std::vector<double> input = { 2, 4, 4, 4, 5, 5, 7, 9 };
+    auto result = input |= trx::stats();
+
+    EXPECT_EQ(result.count(), 8u);
+    EXPECT_DOUBLE_EQ(result.mean(), 5.0);
+    EXPECT_DOUBLE_EQ(result.variance(), 4.0);
+    EXPECT_DOUBLE_EQ(result.min(), 2.0);
+    EXPECT_DOUBLE_EQ(result.max(), 9.0);
+}
+
 TEST(samples, count)
 {
     std::vector<int> input = { 1, 2, 3, 4, 5 };
@@ -302,17 +536,34 @@ TEST(samples, from)
         |= trx::transform([](int a, const std::string& b) -> std::string { return b + ":" + std::to_string(a); })  //
         |= trx::into(std::vector<std::string>{});
 
+    std::vector<std::string> indexed = trx::from(trx::iota(1), input_b)                                   //
+        |= trx::transform([](int i, const std::string& b) { return std::to_string(i) + "." + b; })  //
+        |= trx::into(std::vector<std::string>{});
+
     EXPECT_THAT(result, testing::ElementsAre("two:2", "four:4"));
+    EXPECT_THAT(indexed, testing::ElementsAre("1.one", "2.two", "3.three", "4.four"));
 }
 
 TEST(samples, chain)
 {
     std::vector<int> input_a = { 1, 2, 3 };
     std::vector<int> input_b = { 10, 20, 30 };
-    std::vector<int> result = trx::chain(input_a, input_b)  //
+    std::vector<int> result = trx::chain(input_a, input_b, trx::range(5, 7))  //
+        |= trx::into(std::vector<int>{});
+    std::size_t size = trx::chain(input_a, input_b, std::vector<int>{ 4 }).size();
+
+    EXPECT_THAT(result, testing::ElementsAre(1, 2, 3, 10, 20, 30, 5, 6));
+    EXPECT_THAT(size, 7u);
+}
+
+TEST(samples, merge)
+{
+    std::vector<int> input_a = { 1, 4, 7 };
+    std::vector<int> input_b = { 2, 4, 8, 9 };
+    std::vector<int> result = trx::merge(std::less<>{}, input_a, input_b, trx::range(3, 6))  //
         |= trx::into(std::vector<int>{});
 
-    EXPECT_THAT(result, testing::ElementsAre(1, 2, 3, 10, 20, 30));
+    EXPECT_THAT(result, testing::ElementsAre(1, 2, 3, 4, 4, 4, 5, 7, 8, 9));
 }
 
 TEST(samples, custom_generators)
@@ -347,6 +598,16 @@ TEST(samples, out)
     EXPECT_THAT(result, testing::ElementsAre("1", "2", "3"));
 }
 
+TEST(samples, parallel)
+{
+    std::vector<int> input = { 5, 1, 9, 3, 7, 2, 8 };
+    std::vector<int> result = (input |= trx::parallel(trx::top_k<int>(3), 4)).sorted();
+    int sum = input |= trx::parallel(trx::sum(0), std::plus<>{});
+
+    EXPECT_THAT(result, testing::ElementsAre(9, 8, 7));
+    EXPECT_THAT(sum, testing::Eq(35));
+}
+
 TEST(samples, to_reducer)
 {
     std::vector<int> input = { 5, 10, 15 };
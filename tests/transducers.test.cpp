@@ -1,8 +1,21 @@
 #include <gmock/gmock.h>
 
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <list>
+#include <numeric>
 #include <sstream>
+#include <thread>
 #include <trx/trx.hpp>
 
+#ifdef TRX_HAS_POSIX
+#include <fcntl.h>
+#include <unistd.h>
+#endif  // TRX_HAS_POSIX
+
 namespace
 {
 
@@ -297,6 +310,40 @@ TEST(transducers, intersperse)
     EXPECT_THAT(trx::from(std::string{ "" }) |= xform, testing::Eq(""));
 }
 
+TEST(transducers, distinct)
+{
+    const auto xform = trx::distinct(&std::string::size) |= trx::into(std::vector<std::string>{});
+
+    EXPECT_THAT(trx::reduce(xform, std::vector<std::string>{}), testing::IsEmpty());
+    EXPECT_THAT(
+        trx::reduce(xform, std::vector<std::string>{ "Alabama", "Alaska", "Arizona", "Arkansas", "Ohio", "Utah" }),
+        testing::ElementsAre("Alabama", "Alaska", "Arkansas", "Ohio"));
+}
+
+TEST(transducers, distinct_generic_key)
+{
+    const auto xform = trx::distinct(trx::key_as<std::size_t>([](const auto& s) { return s.size(); }))
+        |= trx::into(std::vector<std::string>{});
+
+    EXPECT_THAT(
+        trx::reduce(xform, std::vector<std::string>{ "Alabama", "Alaska", "Arizona", "Arkansas", "Ohio", "Utah" }),
+        testing::ElementsAre("Alabama", "Alaska", "Arkansas", "Ohio"));
+
+    // Items of different types produce keys of different types, converted to the one stated.
+    const auto first_seen = std::vector<std::string>{ "a", "b", "a" } |= trx::intersperse(std::string_view{ "," })
+        |= trx::distinct(trx::key_as<std::string>([](const auto& s) { return std::string{ s }; }))
+        |= trx::transform([](const auto& s) { return std::string{ s }; }) |= trx::into(std::vector<std::string>{});
+    EXPECT_THAT(first_seen, testing::ElementsAre("a", ",", "b"));
+}
+
+TEST(transducers, distinct_approximate)
+{
+    const auto xform = trx::distinct([](int x) { return x % 5000; }, 5000, 0.01) |= trx::count;
+    const auto result = trx::range(0, 20000) |= xform;
+
+    EXPECT_THAT(result, testing::AllOf(testing::Le(5000u), testing::Ge(4850u)));
+}
+
 TEST(transducers, join_take_with_early_termination)
 {
     EXPECT_THAT(
@@ -347,6 +394,160 @@ TEST(transducers, read_lines)
         testing::ElementsAre("First line", "Second line", "Third line", "Fourth line"));
 }
 
+TEST(transducers, split_lines)
+{
+    const std::vector<std::string> blocks = { "First li", "ne\nSecond line\r", "\n\nThird", " line\r\nFo", "urth line" };
+
+    EXPECT_THAT(
+        blocks |= trx::split_lines |= trx::transform([](std::string_view line) { return std::string{ line }; })
+            |= trx::into(std::vector<std::string>{}),
+        testing::ElementsAre("First line", "Second line", "", "Third line", "Fourth line"));
+    EXPECT_THAT(
+        blocks |= trx::split_lines |= trx::take(2) |= trx::transform([](std::string_view line) { return line.size(); })
+            |= trx::into(std::vector<std::size_t>{}),
+        testing::ElementsAre(10u, 11u));
+}
+
+#ifdef TRX_HAS_POSIX
+
+TEST(transducers, read_blocks)
+{
+    std::string content;
+    for (int i = 0; i < 10000; ++i)
+    {
+        content += std::to_string(i) + "\n";
+    }
+
+    const std::string path = (std::filesystem::temp_directory_path() / "trx_transducers_read_blocks.txt").string();
+    std::ofstream{ path, std::ios::binary } << content;
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    ASSERT_GE(fd, 0);
+    const auto lines = trx::read_blocks(fd, 1000) |= trx::split_lines
+        |= trx::transform([](std::string_view line) { return std::stoi(std::string{ line }); })
+        |= trx::into(std::vector<int>{});
+    ::close(fd);
+    std::filesystem::remove(path);
+    ASSERT_EQ(lines.size(), 10000u);
+    EXPECT_EQ(lines.back(), 9999);
+    EXPECT_TRUE(std::is_sorted(lines.begin(), lines.end()));
+
+    int fds[2];
+    ASSERT_EQ(::pipe(fds), 0);
+    std::thread writer{ [&]
+                        {
+                            for (std::size_t offset = 0; offset < content.size(); offset += 777)
+                            {
+                                const auto size = std::min<std::size_t>(777, content.size() - offset);
+                                EXPECT_EQ(::write(fds[1], content.data() + offset, size), static_cast<::ssize_t>(size));
+                            }
+                            ::close(fds[1]);
+                        } };
+    const auto sizes = trx::read_blocks(fds[0], 4096)
+        |= trx::transform([](trx::span<const char> block) { return block.size(); }) |= trx::into(std::vector<std::size_t>{});
+    writer.join();
+    ::close(fds[0]);
+    ASSERT_FALSE(sizes.empty());
+    EXPECT_EQ(std::accumulate(sizes.begin(), sizes.end(), std::size_t{ 0 }), content.size());
+    EXPECT_TRUE(std::all_of(sizes.begin(), sizes.end(), [](std::size_t size) { return size <= 4096; }));
+
+    // A block of a pipe is returned as soon as some data arrived, and stopping doesn't wait for the writer.
+    ASSERT_EQ(::pipe(fds), 0);
+    std::promise<void> read_first;
+    std::thread slow_writer{ [&]
+                             {
+                                 EXPECT_EQ(::write(fds[1], "first\nsecond\n", 13), 13);
+                                 read_first.get_future().wait_for(std::chrono::seconds{ 10 });
+                                 ::close(fds[1]);
+                             } };
+    const auto start = std::chrono::steady_clock::now();
+    const auto first = trx::read_blocks(fds[0], 4096) |= trx::split_lines
+        |= trx::transform([](std::string_view line) { return std::string{ line }; }) |= trx::take(1)
+        |= trx::into(std::vector<std::string>{});
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    read_first.set_value();
+    slow_writer.join();
+    ::close(fds[0]);
+    EXPECT_THAT(first, testing::ElementsAre("first"));
+    EXPECT_LT(elapsed, std::chrono::seconds{ 5 });
+}
+
+#endif  // TRX_HAS_POSIX
+
+TEST(transducers, cancellation)
+{
+    trx::cancellation_source source;
+    const trx::cancellation_source child{ source.token() };
+    const trx::cancellation_source expired{ std::chrono::milliseconds{ 0 }, child.token() };
+
+    EXPECT_FALSE(trx::cancellation_token{}.stop_requested());
+    EXPECT_FALSE(child.stop_requested());
+    EXPECT_TRUE(expired.stop_requested());
+    EXPECT_EQ(
+        trx::cancellation_source(std::chrono::hours{ 1 }, expired.token()).token().deadline(), expired.token().deadline());
+
+    const std::vector<int> input = { 1, 2, 3, 4, 5, 6 };
+    const auto xform = trx::cancel_on(child.token(), 1) |= trx::into(std::vector<int>{});
+    EXPECT_THAT(input |= xform, testing::ElementsAre(1, 2, 3, 4, 5, 6));
+    EXPECT_THAT(input |= trx::cancel_on(expired.token()) |= trx::into(std::vector<int>{}), testing::IsEmpty());
+    EXPECT_EQ(input |= trx::cancel_on(child.token()) |= trx::parallel(trx::count, std::plus<>{}, 3), 6u);
+    EXPECT_EQ(input |= trx::cancel_on(expired.token()) |= trx::parallel(trx::count, std::plus<>{}, 3), 0u);
+    EXPECT_FALSE((trx::cancel_on(child.token()) |= trx::parallel(trx::count, std::plus<>{}, 3)).m_sequential);
+
+    source.cancel();
+    EXPECT_TRUE(child.stop_requested());
+    EXPECT_THAT(input |= xform, testing::IsEmpty());
+}
+
+TEST(transducers, cancellable_generators)
+{
+    trx::cancellation_source source;
+    const auto stop_at = [&](int n)
+    {
+        return trx::inspect(
+            [&, n](int x)
+            {
+                if (x == n)
+                {
+                    source.cancel();
+                }
+            });
+    };
+
+    EXPECT_THAT(
+        trx::iota(0, source.token(), 4) |= stop_at(5) |= trx::into(std::vector<int>{}),
+        testing::ElementsAre(0, 1, 2, 3, 4, 5, 6, 7));
+
+    std::istringstream is{ "a\nb\nc\nd\n" };
+    EXPECT_THAT(
+        trx::read_lines(is, trx::cancellation_source{ std::chrono::milliseconds{ 0 } }.token())
+            |= trx::into(std::vector<std::string>{}),
+        testing::IsEmpty());
+    EXPECT_THAT(
+        trx::read_lines(is, trx::cancellation_token{}) |= trx::into(std::vector<std::string>{}),
+        testing::ElementsAre("a", "b", "c", "d"));
+
+    EXPECT_THAT(
+        trx::cancellable(std::vector<int>{ 1, 2, 3 }, trx::cancellation_token{}) |= trx::into(std::vector<int>{}),
+        testing::ElementsAre(1, 2, 3));
+
+    trx::cancellation_source other;
+    std::thread canceller{ [&] { other.cancel(); } };
+    trx::iota(0, other.token()) |= trx::count;
+    canceller.join();
+    EXPECT_TRUE(other.stop_requested());
+}
+
+TEST(transducers, take_for)
+{
+    const auto result = trx::iota(0) |= trx::take_for(std::chrono::milliseconds{ 5 }) |= trx::count;
+    EXPECT_GT(result, 0u);
+
+    const std::vector<int> input = { 1, 2, 3 };
+    EXPECT_THAT(
+        input |= trx::take_for(std::chrono::hours{ 1 }) |= trx::into(std::vector<int>{}), testing::ElementsAre(1, 2, 3));
+    EXPECT_THAT(input |= trx::take_for(std::chrono::seconds{ 0 }) |= trx::into(std::vector<int>{}), testing::IsEmpty());
+}
+
 TEST(transducers, unpack)
 {
     const auto xform = trx::unpack |= trx::transform([](int x, int y) { return x + y; }) |= trx::into(std::vector<int>{});
@@ -385,3 +586,402 @@ TEST(transducers, project)
             }),
         testing::ElementsAre("A-e-5", "B-b-3", "C-e-7"));
 }
+
+TEST(transducers, reusable_pipeline)
+{
+    const auto xform = trx::drop(1) |= trx::transform_indexed([](std::ptrdiff_t index, int x) { return index * x; })
+        |= trx::intersperse(-1) |= trx::take(5) |= trx::into(std::vector<int>{});
+    const std::vector<int> input = { 1, 2, 3, 4, 5, 6 };
+
+    EXPECT_THAT(trx::reduce(xform, input), testing::ElementsAre(0, -1, 3, -1, 8));
+    EXPECT_THAT(trx::reduce(xform, input), testing::ElementsAre(0, -1, 3, -1, 8));
+
+    std::vector<std::vector<int>> results(8);
+    std::vector<std::thread> threads;
+    for (auto& result : results)
+    {
+        threads.emplace_back([&]() { result = input |= xform; });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    for (const auto& result : results)
+    {
+        EXPECT_THAT(result, testing::ElementsAre(0, -1, 3, -1, 8));
+    }
+}
+
+TEST(transducers, sliding_window)
+{
+    std::vector<int> input;
+    for (int i = 0; i < 200; ++i)
+    {
+        input.push_back((i * 7919) % 101 - 50);
+    }
+
+    for (std::size_t size : { 1, 2, 5, 16 })
+    {
+        std::vector<int> expected_max;
+        std::vector<double> expected_mean;
+        for (std::size_t i = 0; i < input.size(); ++i)
+        {
+            const auto first = input.begin() + static_cast<std::ptrdiff_t>(i + 1 - std::min(i + 1, size));
+            const auto last = input.begin() + static_cast<std::ptrdiff_t>(i + 1);
+            expected_max.push_back(*std::max_element(first, last));
+            expected_mean.push_back(std::accumulate(first, last, 0.0) / static_cast<double>(last - first));
+        }
+
+        const auto windows = input  //
+            |= trx::sliding_window(size, trx::stats())  //
+            |= trx::into(std::vector<trx::running_stats>{});
+        ASSERT_THAT(windows.size(), input.size());
+        for (std::size_t i = 0; i < windows.size(); ++i)
+        {
+            EXPECT_THAT(windows[i].count(), std::min(i + 1, size));
+            EXPECT_THAT(windows[i].max(), expected_max[i]);
+            EXPECT_THAT(windows[i].mean(), testing::DoubleNear(expected_mean[i], 1e-9));
+        }
+
+        const auto maxima = input
+            |= trx::sliding_window(size, trx::accumulate(-1000, [](int acc, int x) { return std::max(acc, x); }),
+                                   [](int lhs, int rhs) { return std::max(lhs, rhs); })
+            |= trx::into(std::vector<int>{});
+        EXPECT_THAT(maxima, testing::ElementsAreArray(expected_max));
+    }
+
+    EXPECT_THROW(trx::sliding_window(0, trx::stats()), std::invalid_argument);
+}
+
+TEST(transducers, tumbling_window_chrono)
+{
+    using namespace std::chrono_literals;
+    using time_point = std::chrono::time_point<std::chrono::system_clock, std::chrono::milliseconds>;
+    struct record_t
+    {
+        time_point ts;
+        double latency;
+    };
+
+    const auto origin = time_point{ 1h };
+    const std::vector<record_t> input = {
+        { origin + 1s, 10.0 },  { origin + 59s, 30.0 },      { origin + 61s, 5.0 },
+        { origin + 58s, 20.0 }, { origin + 2min + 1s, 1.0 }, { origin + 30s, 99.0 },
+    };
+
+    const auto windows = input
+        |= trx::tumbling_window(
+               [](const record_t& r) -> time_point { return r.ts; },
+               std::chrono::milliseconds{ 1min },
+               trx::project(&record_t::latency) |= trx::stats(),
+               std::chrono::milliseconds{ 10s })
+        |= trx::into(std::vector<trx::time_window<time_point, trx::running_stats>>{});
+
+    ASSERT_THAT(windows.size(), 3u);
+    EXPECT_THAT(windows[0].start, origin);
+    EXPECT_THAT(windows[0].end, origin + 1min);
+    EXPECT_THAT(windows[0].state.count(), 3u);
+    EXPECT_THAT(windows[0].state.mean(), 20.0);
+    EXPECT_THAT(windows[1].start, origin + 1min);
+    EXPECT_THAT(windows[1].state.count(), 1u);
+    EXPECT_THAT(windows[2].start, origin + 2min);
+    EXPECT_THAT(windows[2].state.max(), 1.0);
+
+    const auto first_only = input
+        |= trx::tumbling_window([](const record_t& r) -> time_point { return r.ts; },
+                                std::chrono::milliseconds{ 1min },
+                                trx::count)
+        |= trx::take(1)
+        |= trx::into(std::vector<trx::time_window<time_point, std::size_t>>{});
+    ASSERT_THAT(first_only.size(), 1u);
+    EXPECT_THAT(first_only[0].state, 2u);
+
+    const auto generic = input
+        |= trx::tumbling_window(trx::key_as<time_point>([](const auto& r) { return r.ts; }),
+                                std::chrono::milliseconds{ 1min },
+                                trx::count)
+        |= trx::into(std::vector<trx::time_window<time_point, std::size_t>>{});
+    ASSERT_THAT(generic.size(), 3u);
+    EXPECT_THAT(generic[0].state, 2u);
+
+    const auto ts = [](const record_t& r) -> time_point { return r.ts; };
+    const auto zero = std::chrono::milliseconds{ 0 };
+    EXPECT_THROW(trx::tumbling_window(ts, zero, trx::count), std::invalid_argument);
+    EXPECT_THROW(trx::hopping_window(ts, std::chrono::milliseconds{ 1min }, zero, trx::count), std::invalid_argument);
+    EXPECT_THROW(trx::hopping_window(ts, zero, std::chrono::milliseconds{ 1min }, trx::count), std::invalid_argument);
+    EXPECT_THROW(trx::hopping_window(ts, 10.0, -1.0, trx::count), std::invalid_argument);
+}
+
+TEST(transducers, chunk)
+{
+    std::vector<double> input(1000);
+    std::iota(input.begin(), input.end(), 1.0);
+
+    std::vector<const double*> buffers;
+    std::vector<std::size_t> sizes;
+    const auto result = input
+        |= trx::chunk<double>(64)
+        |= trx::inspect(
+               [&](trx::span<double> batch)
+               {
+                   buffers.push_back(batch.data());
+                   sizes.push_back(batch.size());
+               })
+        |= trx::stats();
+
+    EXPECT_THAT(sizes.size(), 16u);
+    EXPECT_THAT(sizes.back(), 1000u % 64u);
+    EXPECT_THAT(std::count(buffers.begin(), buffers.end(), buffers.front()), 16);
+    EXPECT_THAT(result.count(), 1000u);
+    EXPECT_THAT(result.mean(), 500.5);
+    EXPECT_THAT(result.max(), 1000.0);
+
+    EXPECT_THAT(
+        (input |= trx::chunk<double>(10) |= trx::take(2) |= trx::join |= trx::into(std::vector<double>{})).size(), 20u);
+    EXPECT_THAT((std::vector<double>{} |= trx::chunk<double>(10) |= trx::count), 0u);
+    EXPECT_THAT((std::vector<double>{ 1.0, 2.0, 3.0 } |= trx::chunk<double>(0) |= trx::count), 3u);
+}
+
+TEST(transducers, zip)
+{
+    const std::vector<int> a = { 1, 2, 3, 4, 5 };
+    const std::vector<double> b = { 0.5, 1.5, 2.5, 3.5 };
+    const std::vector<char> c = { 'a', 'b', 'c', 'd', 'e', 'f' };
+    const std::vector<std::string> d = { "w", "x", "y", "z", "v" };
+    const std::vector<bool> e = { true, false, true, false, true };
+
+    const auto to_string = [](int i, double x, char ch, const std::string& s, bool flag)
+    { return std::to_string(i) + ch + s + (flag ? "+" : "-") + std::to_string(static_cast<int>(2 * x)); };
+
+    EXPECT_THAT(
+        trx::reduce(trx::transform(to_string) |= trx::into(std::vector<std::string>{}), a, b, c, d, e),
+        testing::ElementsAre("1aw+1", "2bx-3", "3cy+5", "4dz-7"));
+    EXPECT_THAT(
+        trx::from(a, b, c, d, e) |= trx::transform(to_string) |= trx::into(std::vector<std::string>{}),
+        testing::ElementsAre("1aw+1", "2bx-3", "3cy+5", "4dz-7"));
+
+    const auto pairs = trx::generator_t<int, char>(
+        [](auto yield)
+        {
+            for (int i = 0;; ++i)
+            {
+                if (!yield(i, static_cast<char>('A' + i)))
+                {
+                    return;
+                }
+            }
+        });
+    EXPECT_THAT(
+        trx::reduce(
+            trx::transform([](int x, int i, char ch, const std::string& s) { return std::to_string(x + i) + ch + s; })
+                |= trx::into(std::vector<std::string>{}),
+            a,
+            pairs,
+            d),
+        testing::ElementsAre("1Aw", "3Bx", "5Cy", "7Dz", "9Ev"));
+    EXPECT_THAT(
+        (trx::from(trx::iota(0), a) |= trx::take(2) |= trx::transform(std::multiplies<>{}) |= trx::into(std::vector<int>{})),
+        testing::ElementsAre(0, 2));
+}
+
+TEST(transducers, merge)
+{
+    using item_t = std::pair<int, int>;
+    const auto by_key = [](const item_t& lhs, const item_t& rhs) { return lhs.first > rhs.first; };
+
+    std::vector<std::vector<item_t>> shards(7);
+    std::vector<item_t> expected;
+    for (int i = 0; i < 500; ++i)
+    {
+        const int shard = (i * 31) % 7;
+        if (shard != 3)
+        {
+            shards[static_cast<std::size_t>(shard)].push_back({ (i * 7919) % 97, shard });
+        }
+    }
+    for (auto& shard : shards)
+    {
+        std::stable_sort(shard.begin(), shard.end(), by_key);
+        expected.insert(expected.end(), shard.begin(), shard.end());
+    }
+    std::stable_sort(expected.begin(), expected.end(), by_key);
+
+    const auto shard_6 = trx::generator_t<item_t>(
+        [&](auto yield)
+        {
+            for (const item_t& item : shards[6])
+            {
+                if (!yield(item))
+                {
+                    return;
+                }
+            }
+        });
+    const auto result = trx::merge(by_key, shards[0], shards[1], shards[2], shards[3], shards[4], shards[5], shard_6)
+        |= trx::into(std::vector<item_t>{});
+    EXPECT_THAT(result, testing::ElementsAreArray(expected));
+
+    EXPECT_THAT(
+        trx::merge(std::less<>{}, std::vector<int>{ 2, 1 }) |= trx::into(std::vector<int>{}), testing::ElementsAre(2, 1));
+    EXPECT_THAT(
+        (trx::merge(std::less<>{}, std::vector<int>{ 1, 3, 5 }, std::vector<int>{ 2, 4 }) |= trx::take(3)
+         |= trx::into(std::vector<int>{})),
+        testing::ElementsAre(1, 2, 3));
+
+    const auto stored = trx::merge(std::less<>{}, std::vector<int>{ 1, 4, 7 }, std::vector<int>{ 2, 5 }, trx::range(3, 7));
+    EXPECT_THAT(stored |= trx::into(std::vector<int>{}), testing::ElementsAre(1, 2, 3, 4, 4, 5, 5, 6, 7));
+    EXPECT_THAT(stored |= trx::count, 9u);
+}
+
+TEST(transducers, hash_join)
+{
+    using row_t = std::pair<int, std::string>;
+    const std::vector<row_t> build = { { 1, "a" }, { 2, "b" }, { 1, "c" }, { 3, "d" }, { 1, "e" } };
+    const auto key = [](const row_t& row) { return row.first; };
+    const auto identity = [](int x) { return x; };
+    const std::vector<int> probe = { 1, 4, 3, 2 };
+
+    const auto inner = probe
+        |= trx::hash_join(build, key, identity)
+        |= trx::transform([](int x, const row_t& row) { return std::to_string(x) + row.second; })
+        |= trx::into(std::vector<std::string>{});
+    EXPECT_THAT(inner, testing::ElementsAre("1a", "1c", "1e", "3d", "2b"));
+
+    const auto generic = probe
+        |= trx::hash_join(build, [](const auto& row) { return row.first; }, [](auto x) { return x; })
+        |= trx::transform([](int x, const row_t& row) { return std::to_string(x) + row.second; })
+        |= trx::into(std::vector<std::string>{});
+    EXPECT_THAT(generic, inner);
+
+    const auto left = probe
+        |= trx::left_hash_join(build, key, identity)
+        |= trx::transform([](int x, const row_t* row) { return std::to_string(x) + (row ? row->second : "-"); })
+        |= trx::into(std::vector<std::string>{});
+    EXPECT_THAT(left, testing::ElementsAre("1a", "1c", "1e", "4-", "3d", "2b"));
+
+    const auto semi = probe |= trx::semi_hash_join(build, key, identity) |= trx::into(std::vector<int>{});
+    EXPECT_THAT(semi, testing::ElementsAre(1, 3, 2));
+
+    const auto from_generator = probe
+        |= trx::semi_hash_join(trx::range(2, 4), identity, identity)
+        |= trx::into(std::vector<int>{});
+    EXPECT_THAT(from_generator, testing::ElementsAre(3, 2));
+
+    const auto xform = trx::hash_join(build, key, identity) |= trx::take(2) |= trx::count;
+    EXPECT_THAT(trx::reduce(xform, probe), 2u);
+    EXPECT_THAT(trx::reduce(xform, std::vector<int>{ 3, 2 }), 2u);
+}
+
+TEST(transducers, chain)
+{
+    std::vector<std::vector<int>> partitions;
+    for (int day = 0; day < 30; ++day)
+    {
+        partitions.push_back({ 2 * day, 2 * day + 1 });
+    }
+
+    const auto days = trx::chain(
+        trx::chain(partitions[0], partitions[1], partitions[2]),
+        std::vector<int>{ 6, 7 },
+        trx::range(8, 10),
+        std::array<int, 0>{},
+        partitions[5]);
+    EXPECT_THAT(days |= trx::into(std::vector<int>{}), testing::ElementsAre(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11));
+    EXPECT_THAT(days |= trx::take(7) |= trx::into(std::vector<int>{}), testing::ElementsAre(0, 1, 2, 3, 4, 5, 6));
+    EXPECT_THAT(trx::chain(partitions[0], std::list<int>{ 1, 2 }, partitions[29]).size(), 6u);
+
+    const trx::generator_t<int> erased = trx::chain(partitions[0], partitions[1]);
+    EXPECT_THAT(erased |= trx::into(std::vector<int>{}), testing::ElementsAre(0, 1, 2, 3));
+
+    EXPECT_THAT(
+        trx::from(trx::chain(partitions[2], partitions[3]), partitions[0]) |= trx::transform(std::plus<>{})
+            |= trx::into(std::vector<int>{}),
+        testing::ElementsAre(4, 6));
+    EXPECT_THAT(
+        trx::merge(std::less<>{}, trx::chain(partitions[1], partitions[3]), partitions[2])
+            |= trx::into(std::vector<int>{}),
+        testing::ElementsAre(2, 3, 4, 5, 6, 7));
+}
+
+namespace
+{
+
+constexpr auto crc32_entry(std::uint32_t value) -> std::uint32_t
+{
+    for (int bit = 0; bit < 8; ++bit)
+    {
+        value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+    }
+    return value;
+}
+
+constexpr auto crc32_table() -> std::array<std::uint32_t, 256>
+{
+    std::array<std::uint32_t, 256> table = {};
+    trx::range(0u, 256u) |= trx::transform(crc32_entry) |= trx::copy_to(table.begin());
+    return table;
+}
+
+struct point_t
+{
+    int x;
+    int y;
+};
+
+}  // namespace
+
+TEST(transducers, constexpr_pipelines)
+{
+    constexpr std::array<int, 6> input = { 1, 2, 3, 4, 5, 6 };
+    static_assert(
+        (input |= trx::filter(is_even) |= trx::transform([](int x) { return x * x; }) |= trx::sum(0)) == 4 + 16 + 36);
+    static_assert(
+        (input |= trx::drop(1) |= trx::stride(2) |= trx::take_while([](int x) { return x < 6; }) |= trx::count) == 2);
+    static_assert((trx::iota(1) |= trx::transform([](int x) { return x * x; })
+                   |= trx::take_while([](int x) { return x < 100; }) |= trx::count)
+                  == 9);
+    static_assert((trx::chain(input, trx::range(10, 13)) |= trx::all_of([](int x) { return x > 0; })));
+    static_assert(trx::reduce(trx::transform(std::multiplies<>{}) |= trx::sum(0), input, trx::range(1, 4)) == 1 + 4 + 9);
+
+    constexpr std::array<point_t, 3> points = { { { 1, 2 }, { 3, 4 }, { 5, 6 } } };
+    static_assert((points |= trx::project(&point_t::y) |= trx::sum(0)) == 12);
+
+    constexpr auto table = crc32_table();
+    static_assert(table[0] == 0);
+    static_assert(table[1] == 0x77073096u);
+    static_assert(table[255] == 0x2D02EF8Du);
+    EXPECT_THAT(table[128], 0xEDB88320u);
+}
+
+TEST(transducers, parallel_transform)
+{
+    const auto square = [](int x)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds{ (x * 7919) % 50 });
+        return x * x;
+    };
+
+    std::vector<int> expected(200);
+    std::iota(expected.begin(), expected.end(), 0);
+    std::transform(expected.begin(), expected.end(), expected.begin(), [](int x) { return x * x; });
+
+    EXPECT_EQ(trx::range(0, 200) |= trx::parallel_transform(square, 4, 8) |= trx::into(std::vector<int>{}), expected);
+
+    auto unordered = trx::range(0, 200) |= trx::unordered_parallel_transform(square, 4) |= trx::into(std::vector<int>{});
+    std::sort(unordered.begin(), unordered.end());
+    EXPECT_EQ(unordered, expected);
+
+    EXPECT_THAT(
+        trx::iota(0) |= trx::parallel_transform(square, 3) |= trx::take(4) |= trx::into(std::vector<int>{}),
+        testing::ElementsAre(0, 1, 4, 9));
+
+    const auto throwing = [](int x) { return x == 42 ? throw std::runtime_error{ "42" } : x; };
+    EXPECT_THROW(trx::range(0, 100) |= trx::parallel_transform(throwing, 4) |= trx::count, std::runtime_error);
+
+    // Items of different types, with results of different types.
+    const auto described = std::vector<std::string>{ "ab", "cde" } |= trx::intersperse(std::string_view{ "," })
+        |= trx::parallel_transform([](const auto& s) { return std::make_pair(s, s.size()); }, 2)
+        |= trx::transform([](const auto& p) { return std::string{ p.first } + std::to_string(p.second); })
+        |= trx::into(std::vector<std::string>{});
+    EXPECT_THAT(described, testing::ElementsAre("ab2", ",1", "cde3"));
+}